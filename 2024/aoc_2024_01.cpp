@@ -1,55 +1,323 @@
 // https://adventofcode.com/2024/day/1
 
+#include "list_comparison.hpp"
+#include "shared.hpp"
+#include "solver.hpp"
+
 #include <algorithm>
 #include <array>
-#include <iostream>
-#include <ranges>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
-// Back insert iterator to an array (of size N_ARRAYS) whose elements are
-// vectors of T. Assigned values are added to the vectors in array0, array1,
-// ..., arrayN_ARRAYS, array0, array1, ..., in sequence. Partial but working
-// iterator implementation.
-template <typename T, std::size_t N_ARRAYS>
-struct ArrayOfVectorsBackInserter {
-  std::array<std::vector<T>, N_ARRAYS>& value_vectors;
-  std::size_t array_index = 0;
-
-  ArrayOfVectorsBackInserter& operator=(const int i) {
-    array_index = (array_index + 1) % N_ARRAYS;
-    value_vectors[array_index].push_back(i);
-    return *this;
-  }
-  ArrayOfVectorsBackInserter& operator++() { return *this; }
-  ArrayOfVectorsBackInserter& operator*() { return *this; }
-};
+namespace {
 
-static int calc_distance_sum(std::vector<int> left_values,
-                             std::vector<int> right_values) {
-  std::ranges::sort(left_values);
-  std::ranges::sort(right_values);
-  const auto sum_tuple_distance = [](auto sum,
-                                     const std::tuple<int&, int&>& ints) {
-    const auto distance = std::abs(std::get<1>(ints) - std::get<0>(ints));
-    return sum + distance;
+// Sorts values in O(n) with four stable counting passes over their bytes,
+// skipping passes in which every value has the same byte. Keys have the sign
+// bit flipped so negative values sort first.
+static void radix_sort(std::vector<int>& values) {
+  if (values.empty()) {
+    return;
+  }
+  static constexpr auto N_BUCKETS = 256uz;
+  static constexpr auto N_PASSES = sizeof(std::uint32_t);
+  const auto key = [](const int value) {
+    return static_cast<std::uint32_t>(value) ^ 0x8000'0000u;
   };
-  return std::ranges::fold_left(std::views::zip(left_values, right_values), 0,
-                                sum_tuple_distance);
+  std::array<std::array<std::size_t, N_BUCKETS>, N_PASSES> bucket_counts{};
+  for (const auto value : values) {
+    for (auto pass = 0uz; pass < N_PASSES; pass++) {
+      bucket_counts[pass][(key(value) >> (8 * pass)) & 0xff]++;
+    }
+  }
+  std::vector<int> scratch(values.size());
+  for (auto pass = 0uz; pass < N_PASSES; pass++) {
+    auto& counts = bucket_counts[pass];
+    const auto byte = (key(values.front()) >> (8 * pass)) & 0xff;
+    if (counts[byte] == values.size()) {
+      continue;
+    }
+    auto offset = 0uz;
+    for (auto& count : counts) {
+      offset += std::exchange(count, offset);
+    }
+    for (const auto value : values) {
+      scratch[counts[(key(value) >> (8 * pass)) & 0xff]++] = value;
+    }
+    values.swap(scratch);
+  }
 }
 
-static int calc_similiarity_score(const std::vector<int>& left_values,
-                                  const std::vector<int>& right_values) {
-  auto score = 0;
-  for (const auto left_value : left_values) {
-    score += left_value * std::ranges::count(right_values, left_value);
+// Cursors over a sorted list: a span in memory, or spilled runs merged.
+class SpanCursor {
+ public:
+  explicit SpanCursor(const std::span<const int> values) : values{values} {}
+
+  bool empty() const { return values.empty(); }
+  int front() const { return values.front(); }
+  void pop() { values = values.subspan(1); }
+
+ private:
+  std::span<const int> values;
+};
+
+struct FileCloser {
+  void operator()(std::FILE* file) const { std::fclose(file); }
+};
+
+using TemporaryFile = std::unique_ptr<std::FILE, FileCloser>;
+
+// A sorted run of values spilled to a temporary file.
+struct Run {
+  long offset;
+  std::size_t size;
+};
+
+// Values of one list, buffered until RUN_SIZE of them are sorted and spilled
+// as a run, so memory stays bounded however long the list is.
+class SpilledList {
+ public:
+  static constexpr auto RUN_SIZE = 1uz << 24;
+
+  void push(const int value) {
+    buffer.push_back(value);
+    if (buffer.size() == RUN_SIZE) {
+      spill();
+    }
+  }
+
+  void spill() {
+    if (buffer.empty()) {
+      return;
+    }
+    if (!file) {
+      file.reset(std::tmpfile());
+      if (!file) {
+        throw std::runtime_error{"cannot create a temporary file"};
+      }
+    }
+    radix_sort(buffer);
+    const auto offset = std::ftell(file.get());
+    if (std::fwrite(buffer.data(), sizeof(int), buffer.size(), file.get()) !=
+        buffer.size()) {
+      throw std::runtime_error{"cannot write a temporary file"};
+    }
+    runs.push_back({offset, buffer.size()});
+    buffer.clear();
+  }
+
+  bool has_runs() const { return !runs.empty(); }
+
+  std::span<const int> sorted_buffer() {
+    if (!buffer.empty()) {
+      radix_sort(buffer);
+    }
+    return buffer;
+  }
+
+  std::FILE* run_file() const { return file.get(); }
+
+  std::span<const Run> sorted_runs() const { return runs; }
+
+  void release_buffer() { std::vector<int>{}.swap(buffer); }
+
+ private:
+  std::vector<int> buffer;
+  TemporaryFile file;
+  std::vector<Run> runs;
+};
+
+// Reads one run back a block at a time. Readers of the same file seek before
+// every block, so any number of them can share it.
+class RunReader {
+ public:
+  static constexpr auto BLOCK_SIZE = 1uz << 12;
+
+  RunReader(std::FILE* file, const Run& run)
+      : file{file}, offset{run.offset}, n_unread{run.size} {
+    refill();
   }
-  return score;
+
+  bool empty() const { return block_index == block.size(); }
+  int front() const { return block[block_index]; }
+  void pop() {
+    if (++block_index == block.size()) {
+      refill();
+    }
+  }
+
+ private:
+  void refill() {
+    block.resize(std::min(n_unread, BLOCK_SIZE));
+    block_index = 0;
+    if (block.empty()) {
+      return;
+    }
+    if (std::fseek(file, offset, SEEK_SET) != 0 ||
+        std::fread(block.data(), sizeof(int), block.size(), file) !=
+            block.size()) {
+      throw std::runtime_error{"cannot read a temporary file"};
+    }
+    offset += static_cast<long>(block.size() * sizeof(int));
+    n_unread -= block.size();
+  }
+
+  std::FILE* file;
+  long offset;
+  std::size_t n_unread;
+  std::vector<int> block;
+  std::size_t block_index = 0;
+};
+
+// k-way merge of the runs of a spilled list, smallest front run first.
+class MergeCursor {
+ public:
+  explicit MergeCursor(const SpilledList& list) {
+    for (const auto& run : list.sorted_runs()) {
+      readers.emplace_back(list.run_file(), run);
+    }
+    for (auto reader_index = 0uz; reader_index < readers.size();
+         reader_index++) {
+      if (!readers[reader_index].empty()) {
+        heads.emplace(readers[reader_index].front(), reader_index);
+      }
+    }
+  }
+
+  bool empty() const { return heads.empty(); }
+  int front() const { return heads.top().first; }
+  void pop() {
+    const auto reader_index = heads.top().second;
+    heads.pop();
+    auto& reader = readers[reader_index];
+    reader.pop();
+    if (!reader.empty()) {
+      heads.emplace(reader.front(), reader_index);
+    }
+  }
+
+ private:
+  using Head = std::pair<int, std::size_t>;
+
+  std::vector<RunReader> readers;
+  std::priority_queue<Head, std::vector<Head>, std::greater<>> heads;
+};
+
+// One sweep over both sorted lists: the distance of the values at each
+// position, and each run of equal values joined with the run of that value
+// in the other list. The right list is walked by position and by value, so
+// it takes two cursors.
+template <typename Cursor>
+static ListComparison compare_sorted_lists(Cursor left,
+                                           Cursor right_by_position,
+                                           Cursor right_by_value) {
+  ListComparison comparison;
+  while (!left.empty()) {
+    const auto value = left.front();
+    auto n_left = std::int64_t{0};
+    for (; !left.empty() && left.front() == value; left.pop()) {
+      n_left++;
+      if (!right_by_position.empty()) {
+        comparison.distance_sum +=
+            std::abs(std::int64_t{value} - right_by_position.front());
+        right_by_position.pop();
+      }
+    }
+    while (!right_by_value.empty() && right_by_value.front() < value) {
+      right_by_value.pop();
+    }
+    auto n_right = std::int64_t{0};
+    for (; !right_by_value.empty() && right_by_value.front() == value;
+         right_by_value.pop()) {
+      n_right++;
+    }
+    comparison.similarity_score += value * n_left * n_right;
+  }
+  return comparison;
 }
 
-int main() {
-  std::array<std::vector<int>, 2> values;
-  std::copy(std::istream_iterator<int>{std::cin}, {},
-            ArrayOfVectorsBackInserter{values});
-  std::cout << calc_distance_sum(values[0], values[1]) << "\n";
-  std::cout << calc_similiarity_score(values[0], values[1]) << "\n";
+// Lists that fit in a run are sorted and compared in memory. Longer lists are
+// spilled as sorted runs and compared while merging the runs, so neither list
+// is ever held in memory whole.
+static ListComparison extract_list_comparison(std::istream& istream) {
+  std::array<SpilledList, 2> lists;
+  auto list_index = 0uz;
+  scan_values<int>(istream, [&](const int value) {
+    lists[list_index].push(value);
+    list_index ^= 1;
+  });
+  if (!lists[0].has_runs() && !lists[1].has_runs()) {
+    const auto left = lists[0].sorted_buffer();
+    const auto right = lists[1].sorted_buffer();
+    return compare_sorted_lists(SpanCursor{left}, SpanCursor{right},
+                                SpanCursor{right});
+  }
+  for (auto& list : lists) {
+    list.spill();
+    list.release_buffer();
+  }
+  return compare_sorted_lists(MergeCursor{lists[0]}, MergeCursor{lists[1]},
+                              MergeCursor{lists[1]});
 }
+
+// Feeds each pair through IncrementalListComparison as it is read, as if the
+// lists arrived as a stream, so the timings cover only the appends. Debug
+// builds also keep the lists and assert that comparing them sorted agrees.
+static ListComparison extract_incremental_list_comparison(
+    std::istream& istream) {
+  IncrementalListComparison incremental;
+  std::optional<int> left;
+#if !defined(NDEBUG)
+  std::array<std::vector<int>, 2> lists;
+#endif
+  scan_values<int>(istream, [&](const int value) {
+#if !defined(NDEBUG)
+    lists[left ? 1 : 0].push_back(value);
+#endif
+    if (!left) {
+      left = value;
+      return;
+    }
+    incremental.append(*left, value);
+    left.reset();
+  });
+#if !defined(NDEBUG)
+  for (auto& list : lists) {
+    radix_sort(list);
+  }
+  const auto sorted = compare_sorted_lists(
+      SpanCursor{lists[0]}, SpanCursor{lists[1]}, SpanCursor{lists[1]});
+  assert(incremental.comparison().distance_sum == sorted.distance_sum &&
+         incremental.comparison().similarity_score == sorted.similarity_score);
+#endif
+  return incremental.comparison();
+}
+
+static std::int64_t part_1(const ListComparison& comparison) {
+  return comparison.distance_sum;
+}
+
+static std::int64_t part_2(const ListComparison& comparison) {
+  return comparison.similarity_score;
+}
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(1, extract_list_comparison, part_1, part_2);
+
+[[maybe_unused]] static const auto registered_incremental =
+    register_solver_variant(1, "incremental",
+                            extract_incremental_list_comparison, part_1,
+                            part_2);
@@ -1,70 +1,327 @@
 // https://adventofcode.com/2024/day/2
 
 #include "shared.hpp"
+#include "solver.hpp"
 
 #include <algorithm>
-#include <iostream>
-#include <iterator>
-#include <sstream>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
 
-static bool is_monotonic(const std::vector<int>& values,
-                         const int min_value_distance,
-                         const int max_value_distance) {
-  if (values.size() < 2) {
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+static constexpr auto MIN_VALUE_DISTANCE = 1;
+static constexpr auto MAX_VALUE_DISTANCE = 3;
+
+enum Direction { INCREASING, DECREASING, END };
+
+// all reports' values one after another, report i ending at report_ends[i]
+struct Reports {
+  std::vector<int> values;
+  std::vector<std::size_t> report_ends;
+
+  std::size_t size() const { return report_ends.size(); }
+
+  std::span<const int> operator[](const std::size_t report_index) const {
+    const auto begin = report_index == 0 ? 0 : report_ends[report_index - 1];
+    return std::span{values}.subspan(begin, report_ends[report_index] - begin);
+  }
+};
+
+static bool is_safe_step(const int value, const int next_value,
+                         const std::size_t direction) {
+  const auto value_distance =
+      direction == INCREASING ? next_value - value : value - next_value;
+  return value_distance >= MIN_VALUE_DISTANCE &&
+         value_distance <= MAX_VALUE_DISTANCE;
+}
+
+// Whether the report is safe after removing at most max_removals values.
+// n_removals[i][direction] is the fewest removals before value i that leave a
+// safe report ending at value i. Between two kept values at most max_removals
+// are removed, so each value looks back max_removals + 1 values and the check
+// is O(n) for a fixed max_removals. n_removals is scratch reused over reports.
+static bool is_safe(const std::span<const int> values,
+                    const std::size_t max_removals,
+                    std::vector<std::array<std::size_t, END>>& n_removals) {
+  const auto n_values = values.size();
+  if (n_values <= max_removals + 1) {
     return true;
   }
-  auto previous_value = values[0];
-  const auto is_increasing = values[1] > previous_value;
-  for (auto it = values.cbegin() + 1; it != values.cend(); ++it) {
-    const auto value = *it;
-    const auto value_distance = std::abs(previous_value - value);
-    const auto is_bad_value = value_distance < min_value_distance ||
-                              value_distance > max_value_distance ||
-                              (value > previous_value) != is_increasing;
-    if (is_bad_value) {
-      return false;
+  n_removals.resize(n_values);
+  for (auto i = 0uz; i < n_values; i++) {
+    const auto lookback_begin = i > max_removals ? i - max_removals - 1 : 0;
+    for (auto direction = 0uz; direction < END; direction++) {
+      // every value before i removed
+      auto fewest_removals = i;
+      for (auto j = lookback_begin; j < i; j++) {
+        if (is_safe_step(values[j], values[i], direction)) {
+          fewest_removals =
+              std::min(fewest_removals, n_removals[j][direction] + i - j - 1);
+        }
+      }
+      n_removals[i][direction] = fewest_removals;
+      // every value after i removed
+      if (fewest_removals + n_values - 1 - i <= max_removals) {
+        return true;
+      }
     }
-    previous_value = value;
   }
-  return true;
+  return false;
+}
+
+#if defined(__SSE2__)
+
+// Reports checked side by side, one report per signed 16 bit lane. Compares
+// give all ones in lanes where they hold.
+#if defined(__AVX2__)
+struct LaneOps {
+  using Lanes = __m256i;
+  static constexpr auto N_LANES = 16uz;
+
+  static Lanes load(const std::int16_t* values) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+  }
+  static Lanes set(const int value) {
+    return _mm256_set1_epi16(static_cast<std::int16_t>(value));
+  }
+  static Lanes subtract(const Lanes a, const Lanes b) {
+    return _mm256_sub_epi16(a, b);
+  }
+  static Lanes is_greater(const Lanes a, const Lanes b) {
+    return _mm256_cmpgt_epi16(a, b);
+  }
+  static Lanes both(const Lanes a, const Lanes b) {
+    return _mm256_and_si256(a, b);
+  }
+  static Lanes either(const Lanes a, const Lanes b) {
+    return _mm256_or_si256(a, b);
+  }
+  static Lanes either_not(const Lanes a, const Lanes b) {
+    return _mm256_or_si256(a, _mm256_xor_si256(b, set(-1)));
+  }
+  // two bits per lane
+  static std::uint32_t byte_mask(const Lanes a) {
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(a));
+  }
+};
+#else
+struct LaneOps {
+  using Lanes = __m128i;
+  static constexpr auto N_LANES = 8uz;
+
+  static Lanes load(const std::int16_t* values) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+  }
+  static Lanes set(const int value) {
+    return _mm_set1_epi16(static_cast<std::int16_t>(value));
+  }
+  static Lanes subtract(const Lanes a, const Lanes b) {
+    return _mm_sub_epi16(a, b);
+  }
+  static Lanes is_greater(const Lanes a, const Lanes b) {
+    return _mm_cmpgt_epi16(a, b);
+  }
+  static Lanes both(const Lanes a, const Lanes b) {
+    return _mm_and_si128(a, b);
+  }
+  static Lanes either(const Lanes a, const Lanes b) {
+    return _mm_or_si128(a, b);
+  }
+  static Lanes either_not(const Lanes a, const Lanes b) {
+    return _mm_or_si128(a, _mm_xor_si128(b, set(-1)));
+  }
+  // two bits per lane
+  static std::uint32_t byte_mask(const Lanes a) {
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(a));
+  }
+};
+#endif
+
+using Lanes = LaneOps::Lanes;
+
+static constexpr auto MAX_LANE_LEVELS = 16uz;
+// keeps differences of two values, and of two differences, inside 16 bits
+static constexpr auto MAX_LANE_VALUE = 1 << 13;
+
+static bool fits_lanes(const std::span<const int> values) {
+  return values.size() <= MAX_LANE_LEVELS &&
+         std::ranges::all_of(values, [](const int value) {
+           return value > -MAX_LANE_VALUE && value < MAX_LANE_VALUE;
+         });
 }
 
-static std::vector<int> remove_value(const std::vector<int>& values,
-                                     const std::size_t index) {
-  std::vector<int> new_values;
-  std::copy(
-      values.cbegin(),
-      values.cbegin() + static_cast<std::vector<int>::difference_type>(index),
-      std::back_inserter(new_values));
-  std::copy(values.cbegin() +
-                static_cast<std::vector<int>::difference_type>(index) + 1,
-            values.cend(), std::back_inserter(new_values));
-  return new_values;
+static Lanes is_safe_step(const Lanes value_distance) {
+  return LaneOps::both(
+      LaneOps::is_greater(value_distance,
+                          LaneOps::set(MIN_VALUE_DISTANCE - 1)),
+      LaneOps::is_greater(LaneOps::set(MAX_VALUE_DISTANCE + 1),
+                          value_distance));
 }
 
-int main() {
-  std::vector<std::string> lines;
-  std::copy(std::istream_iterator<Line>{std::cin}, {},
-            std::back_inserter(lines));
-  std::size_t n_safe = 0;
-  std::size_t n_safe_dampened = 0;
-  for (const auto& line : lines) {
-    std::stringstream ss{line};
-    std::vector<int> values;
-    std::copy(std::istream_iterator<int>{ss}, {}, std::back_inserter(values));
+// Number of safe reports among up to N_LANES reports that fit lanes, with at
+// most one value removed if max_removals is 1. Level j of every report is
+// one vector. Removing value r leaves a safe report if the steps before r - 1
+// and after r + 1 are safe and so is the step over r, so the steps are
+// combined into prefix and suffix masks and every r is checked at once
+// across the lanes. Steps past the end of a report count as safe.
+static std::size_t count_safe_lanes(
+    const Reports& reports, const std::span<const std::size_t> report_indices,
+    const std::size_t max_removals) {
+  std::array<std::array<std::int16_t, LaneOps::N_LANES>, MAX_LANE_LEVELS>
+      lane_values{};
+  std::array<std::int16_t, LaneOps::N_LANES> lane_n_levels{};
+  auto n_levels = 0uz;
+  for (auto lane = 0uz; lane < report_indices.size(); lane++) {
+    const auto values = reports[report_indices[lane]];
+    for (auto level = 0uz; level < values.size(); level++) {
+      lane_values[level][lane] = static_cast<std::int16_t>(values[level]);
+    }
+    lane_n_levels[lane] = static_cast<std::int16_t>(values.size());
+    n_levels = std::max(n_levels, values.size());
+  }
+
+  Lanes levels[MAX_LANE_LEVELS];
+  for (auto level = 0uz; level < n_levels; level++) {
+    levels[level] = LaneOps::load(lane_values[level].data());
+  }
+  const auto n_lane_levels = LaneOps::load(lane_n_levels.data());
+  const auto is_before_end = [&](const std::size_t level) {
+    return LaneOps::is_greater(n_lane_levels,
+                               LaneOps::set(static_cast<int>(level)));
+  };
+  const auto all_lanes = LaneOps::set(-1);
+
+  auto is_safe_lane = LaneOps::set(0);
+  for (auto direction = 0uz; direction < END; direction++) {
+    const auto step = [&](const std::size_t from, const std::size_t to) {
+      return direction == INCREASING
+                 ? LaneOps::subtract(levels[to], levels[from])
+                 : LaneOps::subtract(levels[from], levels[to]);
+    };
+    // is_safe_from[i]: every step from level i on is safe
+    Lanes is_safe_from[MAX_LANE_LEVELS + 1];
+    is_safe_from[n_levels] = all_lanes;
+    if (n_levels > 0) {
+      is_safe_from[n_levels - 1] = all_lanes;
+    }
+    for (auto level = n_levels; level-- > 1;) {
+      const auto is_safe_from_step = LaneOps::either_not(
+          is_safe_step(step(level - 1, level)), is_before_end(level));
+      is_safe_from[level - 1] =
+          LaneOps::both(is_safe_from[level], is_safe_from_step);
+    }
+    is_safe_lane = LaneOps::either(is_safe_lane, is_safe_from[0]);
+    if (max_removals == 0) {
+      continue;
+    }
+
+    // is_safe_until: every step up to level r - 1 is safe
+    auto is_safe_until = all_lanes;
+    for (auto removed = 0uz; removed < n_levels; removed++) {
+      auto is_safe_removing = LaneOps::both(
+          is_safe_until, LaneOps::both(is_safe_from[removed + 1],
+                                       is_before_end(removed)));
+      if (removed > 0 && removed + 1 < n_levels) {
+        is_safe_removing = LaneOps::both(
+            is_safe_removing,
+            LaneOps::either_not(is_safe_step(step(removed - 1, removed + 1)),
+                                is_before_end(removed + 1)));
+      }
+      is_safe_lane = LaneOps::either(is_safe_lane, is_safe_removing);
+      if (removed > 0) {
+        is_safe_until = LaneOps::both(
+            is_safe_until, LaneOps::either_not(
+                               is_safe_step(step(removed - 1, removed)),
+                               is_before_end(removed)));
+      }
+    }
+  }
+
+  const auto used_lanes_mask =
+      static_cast<std::uint32_t>((1ull << (2 * report_indices.size())) - 1);
+  return static_cast<std::size_t>(
+      std::popcount(LaneOps::byte_mask(is_safe_lane) & used_lanes_mask) / 2);
+}
 
-    if (is_monotonic(values, 1, 3)) {
+#endif
+
+// Reports that fit 16 bit lanes are checked N_LANES at a time for up to one
+// removal, the others one at a time.
+static std::size_t count_safe_reports(const Reports& reports,
+                                      const std::size_t max_removals) {
+  std::vector<std::array<std::size_t, END>> n_removals;
+  std::size_t n_safe = 0;
+#if defined(__SSE2__)
+  std::array<std::size_t, LaneOps::N_LANES> lane_report_indices;
+  auto n_lane_reports = 0uz;
+#endif
+  for (auto report_index = 0uz; report_index < reports.size();
+       report_index++) {
+#if defined(__SSE2__)
+    if (max_removals <= 1 && fits_lanes(reports[report_index])) {
+      lane_report_indices[n_lane_reports++] = report_index;
+      if (n_lane_reports == LaneOps::N_LANES) {
+        n_safe += count_safe_lanes(reports, lane_report_indices, max_removals);
+        n_lane_reports = 0;
+      }
+      continue;
+    }
+#endif
+    if (is_safe(reports[report_index], max_removals, n_removals)) {
       n_safe++;
     }
+  }
+#if defined(__SSE2__)
+  n_safe += count_safe_lanes(
+      reports, std::span{lane_report_indices}.first(n_lane_reports),
+      max_removals);
+#endif
+  return n_safe;
+}
 
-    for (auto i = 0uz; i < values.size(); i++) {
-      if (is_monotonic(remove_value(values, i), 1, 3)) {
-        n_safe_dampened++;
+static Reports extract_reports(std::istream& istream) {
+  Reports reports;
+  std::string line;
+  while (std::getline(istream, line)) {
+    const auto end = std::as_const(line).data() + line.size();
+    auto it = std::as_const(line).data();
+    while (true) {
+      it = std::find_if(it, end, [](const char c) { return c != ' '; });
+      int value;
+      const auto [value_end, error] = std::from_chars(it, end, value);
+      if (error != std::errc{}) {
         break;
       }
+      reports.values.push_back(value);
+      it = value_end;
     }
+    reports.report_ends.push_back(reports.values.size());
   }
-  std::cout << n_safe << "\n";
-  std::cout << n_safe_dampened << "\n";
+  return reports;
+}
+
+static std::size_t part_1(const Reports& reports) {
+  return count_safe_reports(reports, 0);
 }
+
+static std::size_t part_2(const Reports& reports) {
+  return count_safe_reports(reports, 1);
+}
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(2, extract_reports, part_1, part_2);
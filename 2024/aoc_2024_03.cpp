@@ -1,29 +1,390 @@
 // https://adventofcode.com/2024/day/3
 
-#include <iostream>
+#include "parallel.hpp"
+#include "solver.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
 #include <iterator>
+#include <limits>
 #include <numeric>
+#include <optional>
 #include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// "mul(123,456)"
+static constexpr auto MAX_INSTRUCTION_LENGTH = 12uz;
+// blocks of the input read and scanned at once, split over threads
+static constexpr auto BLOCK_SIZE = 1uz << 24;
+static constexpr auto MIN_CHUNK_SIZE = 1uz << 20;
+
+// Whitespace is skipped, so instructions may span lines.
+static bool is_space(const char c) {
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+         c == '\f';
+}
+
+// Bit i set if block[i] can start an instruction, i.e. is 'm' or 'd', for a
+// block of 64 characters.
+#if defined(__AVX2__)
+static std::uint64_t instruction_start_mask(const char* block) {
+  const auto half_mask = [](const char* half) {
+    const auto chars =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(half));
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('m')),
+                        _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('d')))));
+  };
+  return half_mask(block) | std::uint64_t{half_mask(block + 32)} << 32;
+}
+#elif defined(__SSE2__)
+static std::uint64_t instruction_start_mask(const char* block) {
+  auto mask = std::uint64_t{0};
+  for (auto quarter = 0; quarter < 4; quarter++) {
+    const auto chars = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(block + 16 * quarter));
+    const auto quarter_mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('m')),
+                     _mm_cmpeq_epi8(chars, _mm_set1_epi8('d')))));
+    mask |= std::uint64_t{quarter_mask} << (16 * quarter);
+  }
+  return mask;
+}
+#endif
+
+// Finds the characters of a text that can start an instruction, in order.
+// The mask of a 64-character block is kept until its candidates run out, so
+// dense text costs one block compare per 64 characters rather than one per
+// candidate.
+class InstructionStarts {
+ public:
+  explicit InstructionStarts(const std::string_view text) : text{text} {}
+
+  // first candidate at from or later, or the text size; from never decreases
+  // between calls
+  std::size_t find(std::size_t from) {
+#if defined(__SSE2__)
+    while (true) {
+      if (from >= mask_begin && from - mask_begin < 64) {
+        mask &= ~std::uint64_t{0} << (from - mask_begin);
+        if (mask != 0) {
+          return mask_begin + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+        from = mask_begin + 64;
+      }
+      if (text.size() - from < 64) {
+        break;
+      }
+      mask_begin = from;
+      mask = instruction_start_mask(text.data() + from);
+    }
+#endif
+    for (; from < text.size(); from++) {
+      if (text[from] == 'm' || text[from] == 'd') {
+        return from;
+      }
+    }
+    return text.size();
+  }
+
+ private:
+  std::string_view text;
+#if defined(__SSE2__)
+  // candidates of the 64 characters from mask_begin not yet passed
+  std::size_t mask_begin = std::numeric_limits<std::size_t>::max();
+  std::uint64_t mask = 0;
+#endif
+};
+
+// Sums of the products of the text scanned so far. A chunk scanned without
+// the text before it does not know whether its products before its first
+// do() or don't() are enabled, so they are kept apart until it is appended.
+struct ProductSums {
+  std::int64_t all = 0;
+  std::int64_t enabled = 0;
+  std::int64_t undecided = 0;
+  std::optional<bool> is_enabled;
+
+  // adds the sums of the text right after this one
+  void append(const ProductSums& next) {
+    all += next.all;
+    enabled += next.enabled;
+    if (!is_enabled) {
+      undecided += next.undecided;
+    } else if (*is_enabled) {
+      enabled += next.undecided;
+    }
+    if (next.is_enabled) {
+      is_enabled = next.is_enabled;
+    }
+  }
+};
+
+// Recognises mul(X,Y) with X and Y of 1 to 3 digits, do() and don't() in one
+// forward pass, keeping only the current state between characters. A
+// character that does not continue the current instruction starts over from
+// the initial state, which is enough as 'm' and 'd' only ever start one.
+// Between instructions the scanner skips straight to the next 'm' or 'd'.
+class InstructionScanner {
+ public:
+  explicit InstructionScanner(const std::optional<bool> is_enabled) {
+    product_sums.is_enabled = is_enabled;
+  }
+
+  // scans text, counting only instructions that end at count_begin or later
+  void scan(const std::string_view text, const std::size_t count_begin = 0) {
+    InstructionStarts instruction_starts{text};
+    for (auto i = 0uz; i < text.size(); i++) {
+      if (state == State::START) {
+        i = instruction_starts.find(i);
+        if (i == text.size()) {
+          break;
+        }
+      }
+      if (!is_space(text[i])) {
+        step(text[i], i >= count_begin);
+      }
+    }
+  }
+
+  const ProductSums& sums() const { return product_sums; }
+
+ private:
+  enum class State {
+    START,
+    M,
+    MU,
+    MUL,
+    MULTIPLICATOR,
+    MULTIPLICAND,
+    D,
+    DO,
+    DO_OPEN,
+    DON,
+    DON_APOSTROPHE,
+    DONT,
+    DONT_OPEN,
+  };
+
+  void step(const char c, const bool is_counted) {
+    if (!advance(c, is_counted)) {
+      state = State::START;
+      advance(c, is_counted);
+    }
+  }
 
-static int sum_of_products(const std::string& input) {
+  // whether c continues the current instruction
+  bool advance(const char c, const bool is_counted) {
+    const auto is_digit = c >= '0' && c <= '9';
+    switch (state) {
+      case State::START:
+        return c == 'm'   ? transition(State::M)
+               : c == 'd' ? transition(State::D)
+                          : true;
+      case State::M:
+        return c == 'u' && transition(State::MU);
+      case State::MU:
+        return c == 'l' && transition(State::MUL);
+      case State::MUL:
+        if (c != '(') {
+          return false;
+        }
+        multiplicator = 0;
+        multiplicand = 0;
+        n_digits = 0;
+        return transition(State::MULTIPLICATOR);
+      case State::MULTIPLICATOR:
+        if (is_digit && n_digits < 3) {
+          multiplicator = multiplicator * 10 + (c - '0');
+          n_digits++;
+          return true;
+        }
+        if (c != ',' || n_digits == 0) {
+          return false;
+        }
+        n_digits = 0;
+        return transition(State::MULTIPLICAND);
+      case State::MULTIPLICAND:
+        if (is_digit && n_digits < 3) {
+          multiplicand = multiplicand * 10 + (c - '0');
+          n_digits++;
+          return true;
+        }
+        if (c != ')' || n_digits == 0) {
+          return false;
+        }
+        if (is_counted) {
+          add_product(std::int64_t{multiplicator} * multiplicand);
+        }
+        return transition(State::START);
+      case State::D:
+        return c == 'o' && transition(State::DO);
+      case State::DO:
+        return c == '('   ? transition(State::DO_OPEN)
+               : c == 'n' ? transition(State::DON)
+                          : false;
+      case State::DO_OPEN:
+        if (c != ')') {
+          return false;
+        }
+        if (is_counted) {
+          product_sums.is_enabled = true;
+        }
+        return transition(State::START);
+      case State::DON:
+        return c == '\'' && transition(State::DON_APOSTROPHE);
+      case State::DON_APOSTROPHE:
+        return c == 't' && transition(State::DONT);
+      case State::DONT:
+        return c == '(' && transition(State::DONT_OPEN);
+      case State::DONT_OPEN:
+        if (c != ')') {
+          return false;
+        }
+        if (is_counted) {
+          product_sums.is_enabled = false;
+        }
+        return transition(State::START);
+    }
+    return false;
+  }
+
+  bool transition(const State next_state) {
+    state = next_state;
+    return true;
+  }
+
+  void add_product(const std::int64_t product) {
+    product_sums.all += product;
+    if (!product_sums.is_enabled) {
+      product_sums.undecided += product;
+    } else if (*product_sums.is_enabled) {
+      product_sums.enabled += product;
+    }
+  }
+
+  State state = State::START;
+  int multiplicator = 0;
+  int multiplicand = 0;
+  int n_digits = 0;
+  ProductSums product_sums;
+};
+
+// Start of the text an instruction ending at or after position can start in:
+// MAX_INSTRUCTION_LENGTH - 1 non-space characters before it.
+static std::size_t overlap_begin(const std::string_view text,
+                                 const std::size_t position) {
+  auto begin = position;
+  for (auto n_chars = 0uz; begin > 0 && n_chars < MAX_INSTRUCTION_LENGTH - 1;
+       begin--) {
+    if (!is_space(text[begin - 1])) {
+      n_chars++;
+    }
+  }
+  return begin;
+}
+
+// Scans text from count_begin on in chunks, one thread per chunk. Each chunk
+// starts scanning early enough to see instructions that cross into it, and
+// the chunks' sums are appended in order.
+static ProductSums scan_chunks(const std::string_view text,
+                               const std::size_t count_begin) {
+  const auto n_bytes = text.size() - count_begin;
+  const auto n_chunks =
+      std::clamp(n_bytes / MIN_CHUNK_SIZE, std::size_t{1}, worker_count());
+  const auto chunk_begin = [&](const std::size_t chunk_index) {
+    return count_begin + n_bytes * chunk_index / n_chunks;
+  };
+  std::vector<ProductSums> chunk_sums(n_chunks);
+  parallel_for(n_chunks, [&](const std::size_t chunk_index_begin,
+                             const std::size_t chunk_index_end) {
+    for (auto chunk_index = chunk_index_begin; chunk_index < chunk_index_end;
+         chunk_index++) {
+      const auto begin = chunk_begin(chunk_index);
+      const auto scan_begin = overlap_begin(text, begin);
+      InstructionScanner scanner{std::nullopt};
+      scanner.scan(text.substr(scan_begin, chunk_begin(chunk_index + 1) -
+                                               scan_begin),
+                   begin - scan_begin);
+      chunk_sums[chunk_index] = scanner.sums();
+    }
+  });
+  ProductSums sums;
+  for (const auto& next_sums : chunk_sums) {
+    sums.append(next_sums);
+  }
+  return sums;
+}
+
+// Reads the input one block at a time, each block prefixed with the end of
+// the block before it so instructions crossing blocks are seen whole.
+static ProductSums extract_product_sums(std::istream& istream) {
+  ProductSums sums{.is_enabled = true};
+  std::string text;
+  auto n_carried = 0uz;
+  while (istream) {
+    text.resize(n_carried + BLOCK_SIZE);
+    istream.read(text.data() + n_carried,
+                 static_cast<std::streamsize>(BLOCK_SIZE));
+    text.resize(n_carried + static_cast<std::size_t>(istream.gcount()));
+    sums.append(scan_chunks(text, n_carried));
+    const auto carried_begin = overlap_begin(text, text.size());
+    text.erase(0, carried_begin);
+    n_carried = text.size();
+  }
+  return sums;
+}
+
+static std::int64_t part_1(const ProductSums& sums) { return sums.all; }
+
+static std::int64_t part_2(const ProductSums& sums) { return sums.enabled; }
+
+// the std::regex solver the scanner replaced, kept to compare against
+
+static std::int64_t regex_sum_of_products(const std::string& input) {
   const std::regex regex{"mul\\((\\d{1,3}),(\\d{1,3})\\)"};
   const auto begin = std::sregex_iterator{input.cbegin(), input.cend(), regex};
-  return std::accumulate(begin, {}, 0,
-                         [](const int sum, const std::smatch& match) {
-                           const auto multiplicator = std::stoi(match.str(1));
-                           const auto multiplicand = std::stoi(match.str(2));
-                           return sum + multiplicator * multiplicand;
-                         });
+  return std::accumulate(
+      begin, {}, std::int64_t{0},
+      [](const std::int64_t sum, const std::smatch& match) {
+        const auto multiplicator = std::stoi(match.str(1));
+        const auto multiplicand = std::stoi(match.str(2));
+        return sum + multiplicator * multiplicand;
+      });
 }
 
-int main() {
+static std::string regex_extract_input(std::istream& istream) {
   std::string input;  // regex needs bidirectional iterator
-  std::copy(std::istream_iterator<char>{std::cin}, {},
+  std::copy(std::istream_iterator<char>{istream}, {},
             std::back_inserter(input));
+  return input;
+}
 
-  std::cout << sum_of_products(input) << "\n";
+static std::int64_t regex_part_1(const std::string& input) {
+  return regex_sum_of_products(input);
+}
 
+static std::int64_t regex_part_2(const std::string& input) {
   std::regex regex_trim_donts{"don't\\(\\).*?(do\\(\\)|$)"};
-  input = std::regex_replace(input, regex_trim_donts, "");
-  std::cout << sum_of_products(input) << "\n";
+  return regex_sum_of_products(
+      std::regex_replace(input, regex_trim_donts, ""));
 }
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(3, extract_product_sums, part_1, part_2);
+
+[[maybe_unused]] static const auto registered_regex = register_solver_variant(
+    3, "regex", regex_extract_input, regex_part_1, regex_part_2);
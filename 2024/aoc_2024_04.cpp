@@ -1,68 +1,267 @@
 // https://adventofcode.com/2024/day/4
 
+#include "parallel.hpp"
 #include "shared.hpp"
+#include "solver.hpp"
 
 #include <algorithm>
-#include <iostream>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <string_view>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
-static bool find_xmas_in_direction(const Grid& grid, const Vector2i& location,
-                                   const Vector2i& direction) {
-  static constexpr std::string word = "XMAS";
-  auto word_location = location;
-  for (auto word_index = 0uz; word_index < word.size(); word_index++) {
-    if (!grid.is_inside(word_location)) {
-      return false;
-    }
-    if (grid.location(word_location) != word[word_index]) {
-      return false;
-    }
-    word_location += direction;
+namespace {
+
+struct StencilCell {
+  Vector2i offset;
+  char letter;
+
+  auto operator<=>(const StencilCell&) const = default;
+};
+
+// A 2D pattern of letters at offsets from an anchor location, usable as a
+// template argument, for example
+//   Stencil{std::to_array<StencilCell>({{{0, 0}, 'A'}, {{1, 0}, 'B'}})}
+template <std::size_t N>
+struct Stencil {
+  std::array<StencilCell, N> cells;
+
+  bool operator==(const Stencil&) const = default;
+};
+
+// the stencil with every offset transformed, cells in a canonical order
+template <std::size_t N, typename Transform>
+constexpr Stencil<N> transform_stencil(Stencil<N> stencil,
+                                       const Transform& transform) {
+  for (auto& cell : stencil.cells) {
+    cell.offset = transform(cell.offset);
   }
-  return true;
+  std::ranges::sort(stencil.cells);
+  return stencil;
 }
 
-static int count_xmas(const Grid& grid, const Vector2i& location) {
-  return std::ranges::count_if(
-      Grid::DIRECTIONS, [&](const Vector2i& direction) {
-        return find_xmas_in_direction(grid, location, direction);
+// rotations by 90 degrees of the stencil and of its mirror image, without
+// duplicates from symmetric stencils
+template <std::size_t N>
+struct StencilOrientations {
+  std::array<Stencil<N>, 8> stencils{};
+  std::size_t size = 0;
+};
+
+template <std::size_t N>
+constexpr StencilOrientations<N> find_orientations(const Stencil<N>& stencil) {
+  StencilOrientations<N> orientations;
+  for (const auto is_mirrored : {false, true}) {
+    auto oriented = transform_stencil(stencil, [&](const Vector2i& offset) {
+      return is_mirrored ? Vector2i{-offset.x, offset.y} : offset;
+    });
+    for (auto rotation = 0; rotation < 4; rotation++) {
+      const auto begin = orientations.stencils.cbegin();
+      if (std::find(begin, begin + static_cast<std::ptrdiff_t>(
+                                       orientations.size),
+                    oriented) == begin + static_cast<std::ptrdiff_t>(
+                                             orientations.size)) {
+        orientations.stencils[orientations.size++] = oriented;
+      }
+      oriented = transform_stencil(oriented, [](const Vector2i& offset) {
+        return Vector2i{-offset.y, offset.x};
       });
+    }
+  }
+  return orientations;
 }
 
-static std::pair<std::string, std::string> get_diagonals(
-    const Grid& grid, const Vector2i& location) {
-  return {{grid.location({location.x - 1, location.y - 1}),
-           grid.location({location.x, location.y}),
-           grid.location({location.x + 1, location.y + 1})},
-          {grid.location({location.x + 1, location.y - 1}),
-           grid.location({location.x, location.y}),
-           grid.location({location.x - 1, location.y + 1})}};
-}
+// distinct orientations of STENCIL, generated at compile time
+template <Stencil STENCIL>
+constexpr auto STENCIL_ORIENTATIONS = [] {
+  constexpr auto orientations = find_orientations(STENCIL);
+  std::array<std::remove_const_t<decltype(STENCIL)>, orientations.size>
+      distinct_stencils;
+  std::copy_n(orientations.stencils.cbegin(), orientations.size,
+              distinct_stencils.begin());
+  return distinct_stencils;
+}();
+
+// M.S
+// .A.
+// M.S
+static constexpr Stencil X_MAS{std::to_array<StencilCell>({{{-1, -1}, 'M'},
+                                                           {{1, -1}, 'S'},
+                                                           {{0, 0}, 'A'},
+                                                           {{-1, 1}, 'M'},
+                                                           {{1, 1}, 'S'}})};
 
-static int count_x_mas(const Grid& grid, const Vector2i& location) {
-  const auto diagonals = get_diagonals(grid, location);
-  const auto is_valid_x_mas =
-      (diagonals.first == "MAS" || diagonals.first == "SAM") &&
-      (diagonals.second == "MAS" || diagonals.second == "SAM");
-  return is_valid_x_mas ? 1 : 0;
+// Word word_index of row y as seen from dx columns to the right, for any dx,
+// like BitGrid::word which only shifts by less than a word.
+static std::uint64_t shifted_word(const BitGrid& mask, const int y,
+                                  const std::size_t word_index, const int dx) {
+  const auto word_shift =
+      (dx >= 0 ? dx : dx - BitGrid::WORD_BITS + 1) / BitGrid::WORD_BITS;
+  const auto bit_shift = dx - word_shift * BitGrid::WORD_BITS;
+  const auto shifted_index = static_cast<std::ptrdiff_t>(word_index) +
+                             word_shift;
+  if (shifted_index >= 0) {
+    return mask.word(y, static_cast<std::size_t>(shifted_index), bit_shift);
+  }
+  if (shifted_index == -1 && bit_shift > 0) {
+    return mask.word(y, 0, bit_shift - BitGrid::WORD_BITS);
+  }
+  return 0;
 }
 
-int main() {
-  const Grid grid{std::cin};
+// Finds words in a grid of letters 64 locations at a time. Every letter has a
+// BitGrid of where it is, and the locations where a word is found in one
+// direction are the AND of its letters' masks, each shifted by the letter's
+// offset along the direction.
+class WordSearch {
+ public:
+  explicit WordSearch(const Grid& grid) : grid_size{grid.size()} {
+    letter_indices.fill(NO_LETTER);
+    for (auto y = 0; y < grid_size.y; y++) {
+      auto x = 0uz;
+      for (const auto letter : grid.row(y)) {
+        auto& letter_index = letter_indices[static_cast<unsigned char>(letter)];
+        if (letter_index == NO_LETTER) {
+          letter_index = letter_masks.size();
+          letter_masks.emplace_back(grid_size);
+        }
+        letter_masks[letter_index].row(y)[x / BitGrid::WORD_BITS] |=
+            std::uint64_t{1} << (x % BitGrid::WORD_BITS);
+        x++;
+      }
+    }
+  }
+
+  // number of times word is found in any of the 8 directions
+  std::int64_t count(const std::string_view word) const {
+    return count_matches([&](const int y, const std::size_t word_index,
+                             const std::uint64_t columns) {
+      auto n_matches = 0;
+      for (const auto& direction : Grid::DIRECTIONS) {
+        n_matches +=
+            std::popcount(find_word(word, direction, y, word_index) & columns);
+      }
+      return n_matches;
+    });
+  }
 
-  auto n_xmas = 0;
-  for (auto y = 0; y < grid.size().y; y++) {
-    for (auto x = 0; x < grid.size().x; x++) {
-      n_xmas += count_xmas(grid, {x, y});
+  // Number of anchor locations where STENCIL matches in any orientation. All
+  // cells of all orientations are ANDed and ORed over whole row words, with
+  // the loops over them unrolled at compile time.
+  template <Stencil STENCIL>
+  std::int64_t count_stencil() const {
+    static constexpr auto& orientations = STENCIL_ORIENTATIONS<STENCIL>;
+    static constexpr auto N_CELLS = STENCIL.cells.size();
+    std::array<std::array<const BitGrid*, N_CELLS>, orientations.size()>
+        cell_masks;
+    for (auto o = 0uz; o < orientations.size(); o++) {
+      for (auto c = 0uz; c < N_CELLS; c++) {
+        const auto letter_index = letter_indices[static_cast<unsigned char>(
+            orientations[o].cells[c].letter)];
+        if (letter_index == NO_LETTER) {
+          return 0;
+        }
+        cell_masks[o][c] = &letter_masks[letter_index];
+      }
     }
+    return count_matches([&](const int y, const std::size_t word_index,
+                             const std::uint64_t columns) {
+      const auto find_oriented = [&]<std::size_t O>() {
+        return [&]<std::size_t... C>(std::index_sequence<C...>) {
+          return (shifted_word(*cell_masks[O][C],
+                               y + orientations[O].cells[C].offset.y,
+                               word_index,
+                               orientations[O].cells[C].offset.x) &
+                  ...);
+        }(std::make_index_sequence<N_CELLS>{});
+      };
+      const auto matches = [&]<std::size_t... O>(std::index_sequence<O...>) {
+        return (find_oriented.template operator()<O>() | ...);
+      }(std::make_index_sequence<orientations.size()>{});
+      return std::popcount(matches & columns);
+    });
+  }
+
+ private:
+  static constexpr auto NO_LETTER = std::numeric_limits<std::size_t>::max();
+
+  // Sums count_row_word(y, word_index, columns) over all words of all rows,
+  // with the rows split over threads. columns has the bits of the word that
+  // are inside the grid, since shifted letter masks can carry letters into
+  // the padding past the right edge.
+  template <typename CountRowWord>
+  std::int64_t count_matches(const CountRowWord& count_row_word) const {
+    const auto n_row_words = static_cast<std::size_t>(
+        (grid_size.x + BitGrid::WORD_BITS - 1) / BitGrid::WORD_BITS);
+    const auto last_word_bits = grid_size.x % BitGrid::WORD_BITS;
+    const auto last_word_columns =
+        last_word_bits == 0 ? ~std::uint64_t{0}
+                            : (std::uint64_t{1} << last_word_bits) - 1;
+    std::atomic<std::int64_t> n_matches = 0;
+    parallel_for(static_cast<std::size_t>(grid_size.y),
+                 [&](const std::size_t y_begin, const std::size_t y_end) {
+                   std::int64_t rows_n_matches = 0;
+                   for (auto y = y_begin; y < y_end; y++) {
+                     for (auto w = 0uz; w < n_row_words; w++) {
+                       rows_n_matches += count_row_word(
+                           static_cast<int>(y), w,
+                           w + 1 == n_row_words ? last_word_columns
+                                                : ~std::uint64_t{0});
+                     }
+                   }
+                   n_matches += rows_n_matches;
+                 });
+    return n_matches;
   }
-  std::cout << n_xmas << "\n";
 
-  auto n_x_mas = 0;
-  for (auto y = 1; y < grid.size().y - 1; y++) {
-    for (auto x = 1; x < grid.size().x - 1; x++) {
-      n_x_mas += count_x_mas(grid, {x, y});
+  // Bit i is set if word has letter k at location + k * direction, for
+  // location x = 64 * word_index + i of row y.
+  std::uint64_t find_word(const std::string_view word,
+                          const Vector2i& direction, const int y,
+                          const std::size_t word_index) const {
+    if (word.empty()) {
+      return 0;
     }
+    auto matches = ~std::uint64_t{0};
+    for (auto k = 0uz; k < word.size() && matches != 0; k++) {
+      const auto letter_index =
+          letter_indices[static_cast<unsigned char>(word[k])];
+      if (letter_index == NO_LETTER) {
+        return 0;
+      }
+      const auto offset = static_cast<int>(k);
+      matches &= shifted_word(letter_masks[letter_index],
+                              y + offset * direction.y, word_index,
+                              offset * direction.x);
+    }
+    return matches;
   }
-  std::cout << n_x_mas << "\n";
+
+  Vector2i grid_size;
+  std::array<std::size_t, 256> letter_indices;
+  std::vector<BitGrid> letter_masks;
+};
+
+static WordSearch extract_word_search(std::istream& istream) {
+  return WordSearch{extract_grid(istream)};
+}
+
+static std::int64_t part_1(const WordSearch& word_search) {
+  return word_search.count("XMAS");
 }
+
+static std::int64_t part_2(const WordSearch& word_search) {
+  return word_search.count_stencil<X_MAS>();
+}
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(4, extract_word_search, part_1, part_2);
@@ -1,103 +1,154 @@
 // https://adventofcode.com/2024/day/5
 
 #include "shared.hpp"
+#include "solver.hpp"
 
 #include <algorithm>
-#include <cctype>
-#include <iostream>
-#include <iterator>
-#include <map>
-#include <optional>
-#include <sstream>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
 
-static std::tuple<std::map<int, std::vector<int>>,
-                  std::vector<std::vector<int>>>
-extract_ordering_updates(std::istream& istream) {
-  std::map<int, std::vector<int>> ordering;
-  std::vector<std::vector<int>> updates;
-  for (auto line_it = std::istream_iterator<Line>{istream};
-       line_it != std::istream_iterator<Line>{}; ++line_it) {
-    std::string line;
-    std::ranges::transform(
-        std::string{*line_it}, std::back_inserter(line),
-        [](const char c) { return std::isdigit(c) ? c : ' '; });
-    std::stringstream line_ss{line};
-    std::vector<int> values;
-    std::copy(std::istream_iterator<int>{line_ss}, {},
-              std::back_inserter(values));
-    if (values.size() == 2) {
-      ordering[values[0]].push_back(values[1]);
-    } else if (values.size() > 2) {
-      updates.push_back(values);
+namespace {
+
+using PageId = std::uint32_t;
+
+// Pages are remapped to dense IDs in order of appearance, so the ordering
+// rules fit a bit matrix: bit (after, before) of precedence is set if a rule
+// puts page before ahead of page after. Updates are stored one after another
+// in update_pages, update i ending at update_ends[i].
+struct PrintQueue {
+  std::vector<int> page_numbers;
+  BitGrid precedence{{0, 0}};
+  std::vector<PageId> update_pages;
+  std::vector<std::size_t> update_ends;
+
+  std::size_t n_updates() const { return update_ends.size(); }
+
+  std::span<const PageId> update(const std::size_t update_index) const {
+    const auto begin = update_index == 0 ? 0 : update_ends[update_index - 1];
+    return std::span{update_pages}.subspan(begin,
+                                           update_ends[update_index] - begin);
+  }
+
+  bool is_before(const PageId page, const PageId other_page) const {
+    return precedence.location(
+        {static_cast<int>(other_page), static_cast<int>(page)});
+  }
+};
+
+// the numbers of line, separated by anything that is not a digit
+static void scan_line_numbers(const std::string& line,
+                              std::vector<int>& numbers) {
+  numbers.clear();
+  const auto end = line.data() + line.size();
+  auto it = line.data();
+  while (true) {
+    it = std::find_if(it, end,
+                      [](const char c) { return c >= '0' && c <= '9'; });
+    int number;
+    const auto [number_end, error] = std::from_chars(it, end, number);
+    if (error != std::errc{}) {
+      break;
     }
+    numbers.push_back(number);
+    it = number_end;
   }
-  return {ordering, updates};
 }
 
-static std::optional<std::pair<std::vector<int>::const_iterator,
-                               std::vector<int>::const_iterator>>
-find_bad_page_pair(const std::map<int, std::vector<int>>& ordering,
-                   const std::vector<int>& update) {
-  for (auto update_page_it = update.cbegin(); update_page_it != update.cend();
-       ++update_page_it) {
-    const auto ordering_it = ordering.find(*update_page_it);
-    if (ordering_it == ordering.cend()) {
-      // no page ordering rules for current page
-      continue;
+static PrintQueue extract_print_queue(std::istream& istream) {
+  PrintQueue print_queue;
+  FlatHashMap<int, PageId> page_ids;
+  const auto page_id = [&](const int page_number) {
+    const auto n_pages = static_cast<PageId>(print_queue.page_numbers.size());
+    auto& id = page_ids[page_number];
+    if (page_ids.size() > n_pages) {
+      id = n_pages;
+      print_queue.page_numbers.push_back(page_number);
     }
-    for (const auto after_page : ordering_it->second) {
-      const auto update_page_after_it =
-          std::find(update.cbegin(), update.cend(), after_page);
-      if (update_page_after_it == update.cend()) {
-        // ordering rule specifies page not in update
-        continue;
+    return id;
+  };
+
+  std::vector<std::pair<PageId, PageId>> rules;
+  std::string line;
+  std::vector<int> numbers;
+  while (std::getline(istream, line)) {
+    scan_line_numbers(line, numbers);
+    if (line.find('|') != std::string::npos) {
+      if (numbers.size() == 2) {
+        const auto before = page_id(numbers[0]);
+        rules.emplace_back(before, page_id(numbers[1]));
       }
-      if (update_page_after_it < update_page_it) {
-        // ordering rule specifies page that is before current page in update
-        return {{update_page_it, update_page_after_it}};
+    } else if (!numbers.empty()) {
+      for (const auto number : numbers) {
+        print_queue.update_pages.push_back(page_id(number));
       }
+      print_queue.update_ends.push_back(print_queue.update_pages.size());
     }
   }
-  // no ordering rule violations found
-  return {};
+
+  const auto n_pages = static_cast<int>(print_queue.page_numbers.size());
+  print_queue.precedence = BitGrid{{n_pages, n_pages}};
+  for (const auto& [before, after] : rules) {
+    print_queue.precedence.set(
+        {static_cast<int>(after), static_cast<int>(before)});
+  }
+  return print_queue;
 }
 
-static bool validate_update(const std::map<int, std::vector<int>>& ordering,
-                            const std::vector<int>& update) {
-  return !find_bad_page_pair(ordering, update);
+// Whether no rule puts a page ahead of the page before it. Rules order every
+// pair of pages in an update, so checking adjacent pages is enough.
+static bool is_ordered(const PrintQueue& print_queue,
+                       const std::span<const PageId> update) {
+  for (auto i = 1uz; i < update.size(); i++) {
+    if (print_queue.is_before(update[i], update[i - 1])) {
+      return false;
+    }
+  }
+  return true;
 }
 
-static std::vector<int> reorder_update(
-    const std::map<int, std::vector<int>>& ordering,
-    const std::vector<int>& bad_update) {
-  auto update = bad_update;
-  while (const auto& bad_page_pair = find_bad_page_pair(ordering, update)) {
-    // can't use const_iterators to swap
-    auto& first = *(update.begin() +
-                    std::distance(update.cbegin(), bad_page_pair->first));
-    auto& second = *(update.begin() +
-                     std::distance(update.cbegin(), bad_page_pair->second));
-    std::swap(first, second);
+static std::int64_t part_1(const PrintQueue& print_queue) {
+  std::int64_t middle_page_sum = 0;
+  for (auto update_index = 0uz; update_index < print_queue.n_updates();
+       update_index++) {
+    const auto update = print_queue.update(update_index);
+    if (is_ordered(print_queue, update)) {
+      middle_page_sum += print_queue.page_numbers[update[update.size() / 2]];
+    }
   }
-  return update;
+  return middle_page_sum;
 }
 
-int main() {
-  const auto [ordering, updates] = extract_ordering_updates(std::cin);
-
-  auto mid_page_sum = 0;
-  auto reordered_mid_page_sum = 0;
-  for (const auto& update : updates) {
-    if (validate_update(ordering, update)) {
-      const auto mid_page = update[update.size() / 2];
-      mid_page_sum += mid_page;
-    } else {
-      auto reordered_update = reorder_update(ordering, update);
-      const auto mid_page = reordered_update[update.size() / 2];
-      reordered_mid_page_sum += mid_page;
+// Only the middle page of a reordered update is needed, so it is selected
+// with the rules as comparator instead of sorting the whole update.
+static std::int64_t part_2(const PrintQueue& print_queue) {
+  std::int64_t middle_page_sum = 0;
+  std::vector<PageId> reordered_update;
+  for (auto update_index = 0uz; update_index < print_queue.n_updates();
+       update_index++) {
+    const auto update = print_queue.update(update_index);
+    if (is_ordered(print_queue, update)) {
+      continue;
     }
+    reordered_update.assign(update.begin(), update.end());
+    const auto middle = reordered_update.begin() +
+                        static_cast<std::ptrdiff_t>(update.size() / 2);
+    std::ranges::nth_element(reordered_update, middle,
+                             [&](const PageId page, const PageId other_page) {
+                               return print_queue.is_before(page, other_page);
+                             });
+    middle_page_sum += print_queue.page_numbers[*middle];
   }
-  std::cout << mid_page_sum << "\n";
-  std::cout << reordered_mid_page_sum << "\n";
+  return middle_page_sum;
 }
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(5, extract_print_queue, part_1, part_2);
@@ -1,27 +1,30 @@
 // https://adventofcode.com/2024/day/6
 
+#include "instrumentation.hpp"
+#include "parallel.hpp"
 #include "shared.hpp"
+#include "solver.hpp"
 
 #include <algorithm>
-#include <iostream>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <limits>
 #include <optional>
-#include <set>
+#include <vector>
+
+namespace {
 
 struct Pose {
   Vector2i location;
   std::size_t direction_index;
 
-  bool operator<(const Pose& rhs) const {
-    if (location != rhs.location) {
-      return location < rhs.location;
-    } else {
-      return direction_index < rhs.direction_index;
-    }
-  }
+  bool operator==(const Pose&) const = default;
 };
 
-std::optional<Pose> step(const Grid& grid, const Pose& guard_pose,
-                         const std::optional<Vector2i>& blocked_location) {
+static std::optional<Pose> step(
+    const Grid& grid, const Pose& guard_pose,
+    const std::optional<Vector2i>& blocked_location) {
   auto new_direction_index = guard_pose.direction_index;
   while (true) {
     const auto new_location =
@@ -38,37 +41,280 @@ std::optional<Pose> step(const Grid& grid, const Pose& guard_pose,
   }
 }
 
-std::set<Pose> walk(const Grid& grid, const Pose& pose,
-                    const std::optional<Vector2i>& blocked_location) {
-  std::set<Pose> walked_poses;
+struct PoseIndex {
+  LocationIndex location_index;
+
+  std::size_t operator()(const Pose& pose) const {
+    return location_index(pose.location) * Grid::CARDINAL_DIRECTIONS.size() +
+           pose.direction_index;
+  }
+};
+
+using PoseSet = DenseSet<Pose, PoseIndex>;
+
+static PoseSet make_pose_set(const Grid& grid) {
+  return {grid.n_locations() * Grid::CARDINAL_DIRECTIONS.size(),
+          PoseIndex{{grid.size().x}}};
+}
+
+// Walks until the guard leaves the grid, returning false if it loops
+// instead. walked_poses is cleared first and holds the poses walked.
+static bool walk(const Grid& grid, const Pose& pose,
+                 const std::optional<Vector2i>& blocked_location,
+                 PoseSet& walked_poses) {
+  AOC_COUNT("walk calls");
+  walked_poses.clear();
   std::optional<Pose> maybe_pose{pose};
   while (maybe_pose) {
-    const auto is_loop = walked_poses.contains(*maybe_pose);
+    const auto is_loop = !walked_poses.insert(*maybe_pose);
     if (is_loop) {
-      return {};
+      return false;
     }
-    walked_poses.insert(*maybe_pose);
     maybe_pose = step(grid, *maybe_pose, blocked_location);
   }
-  return walked_poses;
+  return true;
+}
+
+// Sorted positions of the obstacles along each row and each column, so the
+// guard can jump straight to its next turn with a binary search. Memory is
+// one int per obstacle per axis plus one offset per row and column, rather
+// than a distance for every location.
+class ObstacleJumps {
+ public:
+  static constexpr auto NO_OBSTACLE = std::numeric_limits<int>::max();
+
+  explicit ObstacleJumps(const Grid& grid) {
+    const auto width = static_cast<std::size_t>(grid.size().x);
+    const auto height = static_cast<std::size_t>(grid.size().y);
+    row_begins.reserve(height + 1);
+    column_begins.assign(width + 1, 0);
+    for (auto y = 0; y < grid.size().y; y++) {
+      row_begins.push_back(row_xs.size());
+      auto x = 0;
+      for (const auto c : grid.row(y)) {
+        if (c == '#') {
+          row_xs.push_back(x);
+          column_begins[static_cast<std::size_t>(x) + 1]++;
+        }
+        x++;
+      }
+    }
+    row_begins.push_back(row_xs.size());
+    for (auto x = 0uz; x < width; x++) {
+      column_begins[x + 1] += column_begins[x];
+    }
+    // rows are visited top to bottom, so each column comes out sorted
+    column_ys.resize(row_xs.size());
+    auto column_ends = column_begins;
+    for (auto y = 0uz; y < height; y++) {
+      for (auto i = row_begins[y]; i < row_begins[y + 1]; i++) {
+        column_ys[column_ends[static_cast<std::size_t>(row_xs[i])]++] =
+            static_cast<int>(y);
+      }
+    }
+  }
+
+  // distance from location to the next obstacle in direction, or NO_OBSTACLE
+  int obstacle_distance(const Vector2i& location,
+                        const std::size_t direction_index) const {
+    const auto& direction = Grid::CARDINAL_DIRECTIONS[direction_index];
+    const auto is_vertical = direction.x == 0;
+    const auto line_index =
+        static_cast<std::size_t>(is_vertical ? location.x : location.y);
+    const auto& begins = is_vertical ? column_begins : row_begins;
+    const auto& positions = is_vertical ? column_ys : row_xs;
+    const auto line_begin =
+        positions.cbegin() + static_cast<std::ptrdiff_t>(begins[line_index]);
+    const auto line_end = positions.cbegin() +
+                          static_cast<std::ptrdiff_t>(begins[line_index + 1]);
+    const auto position = is_vertical ? location.y : location.x;
+    if (direction.x + direction.y > 0) {
+      const auto it = std::upper_bound(line_begin, line_end, position);
+      return it == line_end ? NO_OBSTACLE : *it - position;
+    }
+    const auto it = std::lower_bound(line_begin, line_end, position);
+    return it == line_begin ? NO_OBSTACLE : position - *std::prev(it);
+  }
+
+ private:
+  // obstacle x of each row, row y from row_xs[row_begins[y]]
+  std::vector<std::size_t> row_begins;
+  std::vector<int> row_xs;
+  // obstacle y of each column, column x from column_ys[column_begins[x]]
+  std::vector<std::size_t> column_begins;
+  std::vector<int> column_ys;
+};
+
+// Pose where the guard next turns walking from pose, facing the way it
+// walked there, with one more obstacle at blocked_location, or nothing if it
+// leaves the grid. The extra obstacle is checked on each jump rather than
+// added to the jumps.
+static std::optional<Pose> find_turn_pose(const ObstacleJumps& jumps,
+                                          const Pose& pose,
+                                          const Vector2i& blocked_location) {
+  const auto& direction = Grid::CARDINAL_DIRECTIONS[pose.direction_index];
+  auto distance = jumps.obstacle_distance(pose.location, pose.direction_index);
+  const auto to_blocked = blocked_location - pose.location;
+  const auto is_blocked_in_line =
+      direction.x == 0 ? to_blocked.x == 0 : to_blocked.y == 0;
+  const auto blocked_distance =
+      to_blocked.x * direction.x + to_blocked.y * direction.y;
+  if (is_blocked_in_line && blocked_distance > 0) {
+    distance = std::min(distance, blocked_distance);
+  }
+  if (distance == ObstacleJumps::NO_OBSTACLE) {
+    return {};
+  }
+  return {{pose.location + (distance - 1) * direction, pose.direction_index}};
 }
 
-int main() {
-  const Grid grid{std::cin};
-  const auto guard_pose = Pose{std::find(grid.cbegin(), grid.cend(), '^'), {}};
+static Pose turn_right(const Pose& pose) {
+  return {pose.location,
+          (pose.direction_index + 1) % Grid::CARDINAL_DIRECTIONS.size()};
+}
 
-  const auto walked_poses = walk(grid, guard_pose, {});
-  std::set<Vector2i> walked_locations;
+// Like walk, but jumping from turn to turn. The guard loops iff it turns
+// twice at the same pose, so only the poses where it turns are kept in
+// turn_poses.
+static bool jump_walk(const ObstacleJumps& jumps, const Pose& pose,
+                      const Vector2i& blocked_location, PoseSet& turn_poses) {
+  AOC_COUNT("jump walk calls");
+  turn_poses.clear();
+  for (auto turn_pose = find_turn_pose(jumps, pose, blocked_location);
+       turn_pose; turn_pose = find_turn_pose(jumps, turn_right(*turn_pose),
+                                             blocked_location)) {
+    if (!turn_poses.insert(*turn_pose)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Like jump_walk, but finding a loop of turn poses with Brent's cycle
+// detection, which keeps two poses however long the walk is. The tortoise
+// waits at a pose while the hare walks on, and moves up to the hare after
+// 1, 2, 4, ... turns, so the hare meets it once the wait exceeds the loop.
+static bool jump_walk_brent(const ObstacleJumps& jumps, const Pose& pose,
+                            const Vector2i& blocked_location) {
+  AOC_COUNT("brent walk calls");
+  const auto next_turn_pose = [&](const Pose& turn_pose) {
+    return find_turn_pose(jumps, turn_right(turn_pose), blocked_location);
+  };
+  auto tortoise = find_turn_pose(jumps, pose, blocked_location);
+  if (!tortoise) {
+    return true;
+  }
+  auto hare = next_turn_pose(*tortoise);
+  auto max_wait = 1uz;
+  auto wait = 1uz;
+  while (hare) {
+    if (*hare == *tortoise) {
+      return false;
+    }
+    if (wait == max_wait) {
+      tortoise = hare;
+      max_wait *= 2;
+      wait = 0;
+    }
+    hare = next_turn_pose(*hare);
+    wait++;
+  }
+  return true;
+}
+
+static Pose find_guard_pose(const Grid& grid) {
+  return {std::find(grid.cbegin(), grid.cend(), '^'), {}};
+}
+
+static LocationSet find_walked_locations(const Grid& grid,
+                                         const Pose& guard_pose) {
+  auto walked_poses = make_pose_set(grid);
+  walk(grid, guard_pose, {}, walked_poses);
+  LocationSet walked_locations{grid.size()};
   for (const auto& pose : walked_poses) {
     walked_locations.insert(pose.location);
   }
-  std::cout << walked_locations.size() << "\n";
+  return walked_locations;
+}
 
-  std::set<Vector2i> looping_block_locations;
-  for (const auto& blocked_location : walked_locations) {
-    if (walk(grid, guard_pose, blocked_location).empty()) {
-      looping_block_locations.insert(blocked_location);
+static std::size_t part_1(const Grid& grid) {
+  return find_walked_locations(grid, find_guard_pose(grid)).size();
+}
+
+// A location the guard walks and the pose it has just before first reaching
+// it. Blocking the location leaves the walk up to that pose unchanged, so a
+// walk with it blocked can start from there.
+struct BlockCandidate {
+  Vector2i location;
+  Pose pose_before;
+};
+
+static std::vector<BlockCandidate> find_block_candidates(
+    const Grid& grid, const Pose& guard_pose) {
+  auto walked_poses = make_pose_set(grid);
+  walk(grid, guard_pose, {}, walked_poses);
+  LocationSet walked_locations{grid.size()};
+  std::vector<BlockCandidate> candidates;
+  // the first walked pose is the guard's own
+  auto previous_pose = guard_pose;
+  for (const auto& pose : walked_poses) {
+    if (walked_locations.insert(pose.location)) {
+      candidates.push_back(
+          {pose.location,
+           {previous_pose.location, pose.direction_index}});
     }
+    previous_pose = pose;
   }
-  std::cout << looping_block_locations.size() << "\n";
+  return candidates;
+}
+
+enum class LoopDetection { TURN_POSE_SET, BRENT };
+
+// Only locations the guard walks can change its walk when blocked, and the
+// walks are independent, so they are split over threads. Each thread reuses
+// one PoseSet unless loops are detected with Brent's algorithm, which needs
+// no set.
+static std::size_t count_looping_block_locations(
+    const Grid& grid, const LoopDetection loop_detection) {
+  const ObstacleJumps jumps{grid};
+  const auto candidates = find_block_candidates(grid, find_guard_pose(grid));
+  std::atomic<std::size_t> n_looping_block_locations = 0;
+  parallel_for(candidates.size(), [&](const std::size_t candidate_begin,
+                                      const std::size_t candidate_end) {
+    std::optional<PoseSet> turn_poses;
+    if (loop_detection == LoopDetection::TURN_POSE_SET) {
+      turn_poses = make_pose_set(grid);
+    }
+    std::size_t n_looping = 0;
+    for (auto candidate_index = candidate_begin;
+         candidate_index < candidate_end; candidate_index++) {
+      const auto& candidate = candidates[candidate_index];
+      const auto is_leaving =
+          turn_poses ? jump_walk(jumps, candidate.pose_before,
+                                 candidate.location, *turn_poses)
+                     : jump_walk_brent(jumps, candidate.pose_before,
+                                       candidate.location);
+      if (!is_leaving) {
+        n_looping++;
+      }
+    }
+    n_looping_block_locations += n_looping;
+  });
+  return n_looping_block_locations;
 }
+
+static std::size_t part_2(const Grid& grid) {
+  return count_looping_block_locations(grid, LoopDetection::TURN_POSE_SET);
+}
+
+static std::size_t part_2_brent(const Grid& grid) {
+  return count_looping_block_locations(grid, LoopDetection::BRENT);
+}
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(6, extract_grid, part_1, part_2);
+
+[[maybe_unused]] static const auto registered_brent =
+    register_solver_variant(6, "brent", extract_grid, part_1, part_2_brent);
@@ -1,19 +1,22 @@
 // https://adventofcode.com/2024/day/7
 
 #include "shared.hpp"
+#include "solver.hpp"
 
 #include <algorithm>
 #include <cmath>
-#include <iostream>
+#include <istream>
 #include <sstream>
 #include <vector>
 
+namespace {
+
 struct Calibration {
   std::int64_t result;
   std::vector<std::int64_t> operands;
 };
 
-std::vector<Calibration> extract_calibrations(std::istream& istream) {
+static std::vector<Calibration> extract_calibrations(std::istream& istream) {
   std::vector<Calibration> calibrations;
   for (auto line_it = std::istream_iterator<Line>{istream};
        line_it != std::istream_iterator<Line>{}; ++line_it) {
@@ -88,8 +91,8 @@ struct Operators {
   std::vector<Operator> operators;
 };
 
-bool test_calibration(const Calibration& calibration,
-                      const std::string& available_operators) {
+static bool test_calibration(const Calibration& calibration,
+                             const std::string& available_operators) {
   Operators operators{calibration.operands.size() - 1, available_operators};
   while (true) {
     if (operators.evaluate(calibration.operands) == calibration.result) {
@@ -101,22 +104,27 @@ bool test_calibration(const Calibration& calibration,
   }
 }
 
-int main() {
-  const auto calibrations = extract_calibrations(std::cin);
-
+static std::int64_t part_1(const std::vector<Calibration>& calibrations) {
   std::int64_t n_calibration_sum = 0;
   for (const auto& calibration : calibrations) {
     if (test_calibration(calibration, "+*")) {
       n_calibration_sum += calibration.result;
     }
   }
-  std::cout << n_calibration_sum << "\n";
+  return n_calibration_sum;
+}
 
+static std::int64_t part_2(const std::vector<Calibration>& calibrations) {
   std::int64_t n_calibration_sum_concat = 0;
   for (const auto& calibration : calibrations) {
     if (test_calibration(calibration, "+*|")) {
       n_calibration_sum_concat += calibration.result;
     }
   }
-  std::cout << n_calibration_sum_concat << "\n";
+  return n_calibration_sum_concat;
 }
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(7, extract_calibrations, part_1, part_2);
@@ -1,25 +1,23 @@
 // https://adventofcode.com/2024/day/8
 
 #include "shared.hpp"
+#include "solver.hpp"
 
 #include <cctype>
-#include <iostream>
-#include <map>
 #include <ranges>
-#include <set>
 #include <vector>
 
-int main() {
-  const Grid grid{std::cin};
-  std::map<char, std::vector<Vector2i>> all_freq_antennae;
+namespace {
+
+static LocationSet find_antinodes(const Grid& grid, const bool is_resonant) {
+  FlatHashMap<char, std::vector<Vector2i>> all_freq_antennae;
   for (auto grid_it = grid.cbegin(); grid_it != grid.cend(); ++grid_it) {
     if (std::isalnum(*grid_it)) {
       all_freq_antennae[*grid_it].push_back(grid_it);
     }
   }
 
-  std::set<Vector2i> antinodes;
-  std::set<Vector2i> multi_antinodes;
+  LocationSet antinodes{grid.size()};
   for (const auto& single_freq_antennae : all_freq_antennae) {
     const auto& anntennae_locations = single_freq_antennae.second;
     for (const auto& [antenna_location_a, antenna_location_b] :
@@ -32,16 +30,31 @@ int main() {
       const auto antenna_location_delta =
           antenna_location_b - antenna_location_a;
 
-      if (grid.is_inside(antinode_location - antenna_location_delta)) {
-        antinodes.insert(antinode_location - antenna_location_delta);
+      if (!is_resonant) {
+        if (grid.is_inside(antinode_location - antenna_location_delta)) {
+          antinodes.insert(antinode_location - antenna_location_delta);
+        }
+        continue;
       }
 
       while (grid.is_inside(antinode_location)) {
-        multi_antinodes.insert(antinode_location);
+        antinodes.insert(antinode_location);
         antinode_location -= antenna_location_delta;
       }
     }
   }
-  std::cout << antinodes.size() << "\n";
-  std::cout << multi_antinodes.size() << "\n";
+  return antinodes;
+}
+
+static std::size_t part_1(const Grid& grid) {
+  return find_antinodes(grid, false).size();
 }
+
+static std::size_t part_2(const Grid& grid) {
+  return find_antinodes(grid, true).size();
+}
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(8, extract_grid, part_1, part_2);
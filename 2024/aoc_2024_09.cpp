@@ -1,13 +1,16 @@
 // https://adventofcode.com/2024/day/9
 
 #include "shared.hpp"
+#include "solver.hpp"
 
 #include <algorithm>
-#include <iostream>
 #include <istream>
 #include <iterator>
+#include <optional>
 #include <vector>
 
+namespace {
+
 static constexpr auto FREE_BLOCK_ID = -1;
 static bool is_free_block(const int file_id) {
   return file_id == FREE_BLOCK_ID;
@@ -108,8 +111,15 @@ static std::int64_t calc_checksum(const std::vector<int>& disk_map) {
   return std::ranges::fold_left(disk_map, std::int64_t{}, checksum);
 }
 
-int main() {
-  const auto disk_map = extract_disk_map(std::cin);
-  std::cout << calc_checksum(defragment_free_blocks(disk_map)) << "\n";
-  std::cout << calc_checksum(defragment_files(disk_map)) << "\n";
+static std::int64_t part_1(const std::vector<int>& disk_map) {
+  return calc_checksum(defragment_free_blocks(disk_map));
+}
+
+static std::int64_t part_2(const std::vector<int>& disk_map) {
+  return calc_checksum(defragment_files(disk_map));
 }
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(9, extract_disk_map, part_1, part_2);
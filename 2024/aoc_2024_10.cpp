@@ -1,55 +1,99 @@
 // https://adventofcode.com/2024/day/10
 
+#include "parallel.hpp"
 #include "shared.hpp"
+#include "solver.hpp"
 
-#include <iostream>
-#include <set>
-#include <stack>
-#include <utility>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
-std::pair<int, int> score_trail(const Grid& grid,
-                                const Vector2i& from_location) {
-  const auto is_trailhead = grid.location(from_location) == '0';
-  if (!is_trailhead) {
-    return {};
+namespace {
+
+static void visit_uphill_locations(const Grid& grid, const Vector2i& location,
+                                   const auto& visit) {
+  const auto height = grid.location(location);
+  for (const auto& direction : Grid::CARDINAL_DIRECTIONS) {
+    const auto maybe_next_location = location + direction;
+    const auto is_valid_next_location =
+        grid.is_inside(maybe_next_location) &&
+        grid.location(maybe_next_location) == height + 1;
+    if (is_valid_next_location) {
+      visit(maybe_next_location);
+    }
   }
+}
 
-  std::set<Vector2i> trailtails;
-  auto n_trails = 0;
-  std::stack<Vector2i> location_to_walk{{from_location}};
-  while (!location_to_walk.empty()) {
-    const auto location = location_to_walk.top();
-    location_to_walk.pop();
-
-    const auto height = grid.location(location);
-    const auto is_trailtail = height == '9';
-    if (is_trailtail) {
-      trailtails.insert(location);
-      n_trails++;
-    } else {
-      for (const auto& direction : Grid::CARDINAL_DIRECTIONS) {
-        const auto maybe_next_location = location + direction;
-        const auto is_valid_next_location =
-            grid.is_inside(maybe_next_location) &&
-            grid.location(maybe_next_location) == height + 1;
-        if (is_valid_next_location) {
-          location_to_walk.push(maybe_next_location);
+// Number of trailtails reachable from each trailhead, rows split over
+// threads. Each thread reuses one visited set, which clears only the locations
+// it inserted, and one stack of locations to visit.
+static std::int64_t part_1(const Grid& grid) {
+  std::atomic<std::int64_t> trailtail_score = 0;
+  parallel_for_rows(grid, [&](const int y_begin, const int y_end) {
+    LocationSet visited{grid.size()};
+    std::vector<Vector2i> to_visit;
+    std::int64_t rows_trailtail_score = 0;
+    const auto row_begin = [&grid](const int y) {
+      return grid.cbegin() + static_cast<std::ptrdiff_t>(grid.index({0, y}));
+    };
+    for (auto grid_it = row_begin(y_begin); grid_it != row_begin(y_end);
+         ++grid_it) {
+      const auto is_trailhead = *grid_it == '0';
+      if (!is_trailhead) {
+        continue;
+      }
+      visited.clear();
+      const Vector2i trailhead = grid_it;
+      visited.insert(trailhead);
+      to_visit.push_back(trailhead);
+      while (!to_visit.empty()) {
+        const auto location = to_visit.back();
+        to_visit.pop_back();
+        if (grid.location(location) == '9') {
+          rows_trailtail_score++;
+          continue;
         }
+        visit_uphill_locations(grid, location, [&](const Vector2i& next) {
+          if (visited.insert(next)) {
+            to_visit.push_back(next);
+          }
+        });
       }
     }
-  }
-  return {trailtails.size(), n_trails};
+    trailtail_score += rows_trailtail_score;
+  });
+  return trailtail_score;
 }
 
-int main() {
-  const Grid grid{std::cin};
-  auto trailtail_score = 0;
-  auto trail_score = 0;
-  for (auto grid_it = grid.cbegin(); grid_it != grid.cend(); ++grid_it) {
-    const auto [tts, ts] = score_trail(grid, grid_it);
-    trailtail_score += tts;
-    trail_score += ts;
+// Number of trails from each trailhead. Trails only go uphill, so the number
+// of trails from a location is the sum over its uphill neighbours, counted
+// from the top down.
+static std::int64_t part_2(const Grid& grid) {
+  Matrix<std::int64_t> n_trails{grid.size()};
+  std::int64_t trail_score = 0;
+  for (auto height = '9'; height >= '0'; height--) {
+    for (auto grid_it = grid.cbegin(); grid_it != grid.cend(); ++grid_it) {
+      if (*grid_it != height) {
+        continue;
+      }
+      const Vector2i location = grid_it;
+      auto& location_n_trails = n_trails.location(location);
+      if (height == '9') {
+        location_n_trails = 1;
+      }
+      visit_uphill_locations(grid, location, [&](const Vector2i& next) {
+        location_n_trails += n_trails.location(next);
+      });
+      if (height == '0') {
+        trail_score += location_n_trails;
+      }
+    }
   }
-  std::cout << trailtail_score << "\n";
-  std::cout << trail_score << "\n";
+  return trail_score;
 }
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(10, extract_grid, part_1, part_2);
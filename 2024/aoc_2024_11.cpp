@@ -1,9 +1,11 @@
 // https://adventofcode.com/2024/day/11
 
 #include "shared.hpp"
+#include "solver.hpp"
 
 #include <cmath>
-#include <iostream>
+#include <istream>
+#include <iterator>
 #include <map>
 #include <optional>
 #include <ranges>
@@ -11,6 +13,8 @@
 #include <utility>
 #include <vector>
 
+namespace {
+
 static std::optional<std::pair<std::int64_t, std::int64_t>>
 split_even_digit_count_numbers(const int64_t number) {
   const auto digit_count = static_cast<int>(std::log10(number)) + 1;
@@ -80,11 +84,26 @@ static std::map<Number, std::size_t> build_cached_counts(
   return cached_counts;
 }
 
-int main() {
-  const auto cached_counts =
-      build_cached_counts(std::views::iota(0, 10), std::views::iota(0uz, 42uz));
-  std::vector<Number> numbers{std::istream_iterator<std::int64_t>{std::cin},
-                              {}};
-  std::cout << count_numbers(numbers, 25, cached_counts) << "\n";
-  std::cout << count_numbers(numbers, 75, cached_counts) << "\n";
+struct Stones {
+  std::vector<Number> numbers;
+  std::map<Number, std::size_t> cached_counts;
+};
+
+static Stones extract_stones(std::istream& istream) {
+  return {{std::istream_iterator<std::int64_t>{istream}, {}},
+          build_cached_counts(std::views::iota(0, 10),
+                              std::views::iota(0uz, 42uz))};
+}
+
+static std::size_t part_1(const Stones& stones) {
+  return count_numbers(stones.numbers, 25, stones.cached_counts);
+}
+
+static std::size_t part_2(const Stones& stones) {
+  return count_numbers(stones.numbers, 75, stones.cached_counts);
 }
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(11, extract_stones, part_1, part_2);
@@ -1,105 +1,143 @@
 // https://adventofcode.com/2024/day/12
 
+#include "parallel.hpp"
 #include "shared.hpp"
+#include "solver.hpp"
 
-#include <algorithm>
 #include <array>
-#include <bitset>
-#include <iostream>
-#include <map>
-#include <set>
-#include <stack>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
 
-static std::set<Vector2i> find_connected_locations(
-    const Grid& grid, const Vector2i& start_location) {
-  std::stack<Vector2i> locations_to_visit;
-  locations_to_visit.push(start_location);
-  std::set<Vector2i> connected_locations;
-  while (!locations_to_visit.empty()) {
-    const auto location = locations_to_visit.top();
-    locations_to_visit.pop();
+namespace {
 
-    if (connected_locations.contains(location)) {
-      continue;
-    }
-    connected_locations.insert(location);
+struct Region {
+  std::int64_t area;
+  std::int64_t perimeter;
+  std::int64_t n_double_edges;
+};
 
-    for (const auto delta : Grid::CARDINAL_DIRECTIONS) {
-      const auto maybe_new_location = location + delta;
-      const auto is_connected_location =
-          grid.is_inside(maybe_new_location) &&
-          grid.location(maybe_new_location) == grid.location(start_location);
-      if (is_connected_location) {
-        locations_to_visit.push(maybe_new_location);
-      }
+static std::int64_t popcount(const std::uint64_t bits) {
+  return std::popcount(bits);
+}
+
+// Area, perimeter and double edges of the region set in locations, counted
+// 64 locations at a time over the region's bounds.
+static Region measure_region(const BitGrid& locations,
+                             const BitGridBounds& bounds) {
+  Region region{};
+  auto internal_perimeter = std::int64_t{0};
+  for (auto y = bounds.y_begin; y < bounds.y_end; y++) {
+    for (auto w = bounds.word_begin; w < bounds.word_end; w++) {
+      const auto bits = locations.word(y, w);
+      region.area += popcount(bits);
+      internal_perimeter += popcount(bits & locations.word(y, w, 1)) +
+                            popcount(bits & locations.word(y + 1, w));
     }
   }
-  return connected_locations;
-}
+  region.perimeter = 4 * region.area - 2 * internal_perimeter;
 
-static std::bitset<4> get_patch(const std::set<Vector2i>& locations,
-                                const Vector2i& top_left_corner_location) {
-  const auto x = top_left_corner_location.x;
-  const auto y = top_left_corner_location.y;
-  return static_cast<unsigned long long>(
-      locations.contains({x + 0, y + 0}) << 0 |
-      locations.contains({x + 1, y + 0}) << 1 |
-      locations.contains({x + 0, y + 1}) << 2 |
-      locations.contains({x + 1, y + 1}) << 3);
+  // A double edge is a 2x2 patch with two adjacent locations inside the
+  // region and the other two outside it. Patch bit x has its top left corner
+  // at location x.
+  const auto word_begin = bounds.word_begin == 0 ? 0 : bounds.word_begin - 1;
+  for (auto y = bounds.y_begin - 1; y < bounds.y_end; y++) {
+    for (auto w = word_begin; w < bounds.word_end; w++) {
+      const auto top_left = locations.word(y, w);
+      const auto top_right = locations.word(y, w, 1);
+      const auto bottom_left = locations.word(y + 1, w);
+      const auto bottom_right = locations.word(y + 1, w, 1);
+      region.n_double_edges +=
+          popcount(~top_left & ~top_right & bottom_left & bottom_right) +
+          popcount(top_left & top_right & ~bottom_left & ~bottom_right) +
+          popcount(~top_left & top_right & ~bottom_left & bottom_right) +
+          popcount(top_left & ~top_right & bottom_left & ~bottom_right);
+    }
+    if (bounds.word_begin == 0) {
+      // patches with their left column outside the grid
+      region.n_double_edges +=
+          static_cast<std::int64_t>(locations.word(y, 0) &
+                                    locations.word(y + 1, 0) & 1);
+    }
+  }
+  return region;
 }
 
-static int calc_perimeter(const std::set<Vector2i>& locations) {
-  auto internal_perimeter = 0;
-  for (const auto& location : locations) {
-    for (const auto& delta : Grid::CARDINAL_DIRECTIONS) {
-      internal_perimeter += locations.contains(location + delta);
+// regions of one plant, flood filled from each still unvisited plot
+static void find_plant_regions(const Grid& grid, const char plant,
+                               BitGridSearch& search,
+                               std::vector<Region>& regions) {
+  const BitGrid plots{grid, [plant](const char c) { return c == plant; }};
+  auto unvisited_plots = plots;
+  for (auto y = 0; y < grid.size().y; y++) {
+    const auto unvisited_row = unvisited_plots.row(y);
+    for (auto w = 0uz; w < unvisited_row.size(); w++) {
+      while (unvisited_row[w] != 0) {
+        const auto x = static_cast<int>(w) * BitGrid::WORD_BITS +
+                       std::countr_zero(unvisited_row[w]);
+        search.flood_fill(plots, {x, y});
+        const auto& bounds = search.visited_bounds();
+        regions.push_back(measure_region(search.visited(), bounds));
+        for (auto ry = bounds.y_begin; ry < bounds.y_end; ry++) {
+          for (auto rw = bounds.word_begin; rw < bounds.word_end; rw++) {
+            unvisited_plots.row(ry)[rw] &= ~search.visited().word(ry, rw);
+          }
+        }
+      }
     }
   }
-  return 4 * static_cast<int>(locations.size()) - internal_perimeter;
 }
 
-static int count_double_edges(const std::set<Vector2i>& locations) {
-  static constexpr auto DOUBLE_EDGE_PATCHES =
-      std::to_array<std::bitset<4>>({0b1100, 0b0011, 0b1010, 0b0101});
-  Vector2i location_min{std::numeric_limits<int>::max(),
-                        std::numeric_limits<int>::max()};
-  Vector2i location_max{std::numeric_limits<int>::min(),
-                        std::numeric_limits<int>::min()};
-  for (const auto& location : locations) {
-    location_min = {std::min(location_min.x, location.x),
-                    std::min(location_min.y, location.y)};
-    location_max = {std::max(location_max.x, location.x),
-                    std::max(location_max.y, location.y)};
+// plants are independent, so they are split over threads
+static std::vector<Region> find_regions(const Grid& grid) {
+  std::array<bool, 256> has_plant{};
+  for (const auto c : grid) {
+    has_plant[static_cast<unsigned char>(c)] = true;
   }
-  auto count = 0;
-  for (auto y = location_min.y - 1; y < location_max.y + 1; y++) {
-    for (auto x = location_min.x - 1; x < location_max.x + 1; x++) {
-      const auto patch = get_patch(locations, {x, y});
-      count += std::ranges::count(DOUBLE_EDGE_PATCHES, patch);
+  std::vector<char> plants;
+  for (auto plant_index = 0uz; plant_index < has_plant.size(); plant_index++) {
+    if (has_plant[plant_index]) {
+      plants.push_back(static_cast<char>(plant_index));
     }
   }
-  return count;
-}
 
-int main() {
-  const Grid grid{std::cin};
+  std::vector<Region> regions;
+  std::mutex regions_mutex;
+  parallel_for(plants.size(), [&](const std::size_t plant_begin,
+                                  const std::size_t plant_end) {
+    BitGridSearch search{grid.size()};
+    std::vector<Region> plants_regions;
+    for (auto plant_index = plant_begin; plant_index < plant_end;
+         plant_index++) {
+      find_plant_regions(grid, plants[plant_index], search, plants_regions);
+    }
+    const std::lock_guard lock{regions_mutex};
+    regions.insert(regions.cend(), plants_regions.cbegin(),
+                   plants_regions.cend());
+  });
+  return regions;
+}
 
-  std::map<Vector2i, std::set<Vector2i>> regions;
-  for (auto grid_it = grid.cbegin(); grid_it != grid.cend(); ++grid_it) {
-    const auto locations = find_connected_locations(grid, grid_it);
-    regions[std::ranges::min(locations)] = locations;
+static std::int64_t part_1(const Grid& grid) {
+  std::int64_t price = 0;
+  for (const auto& region : find_regions(grid)) {
+    price += region.area * region.perimeter;
   }
+  return price;
+}
 
-  auto price = 0;
-  auto discount_price = 0;
-  for (const auto& region : regions) {
-    const auto& locations = region.second;
-    const auto area = static_cast<int>(locations.size());
-    const auto perimeter = calc_perimeter(locations);
-    const auto n_edges = perimeter - count_double_edges(locations);
-    price += area * perimeter;
-    discount_price += area * n_edges;
+static std::int64_t part_2(const Grid& grid) {
+  std::int64_t discount_price = 0;
+  for (const auto& region : find_regions(grid)) {
+    const auto n_edges = region.perimeter - region.n_double_edges;
+    discount_price += region.area * n_edges;
   }
-  std::cout << price << "\n";
-  std::cout << discount_price << "\n";
+  return discount_price;
 }
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(12, extract_grid, part_1, part_2);
@@ -1,20 +1,23 @@
 // https://adventofcode.com/2024/day/13
 
 #include "shared.hpp"
+#include "solver.hpp"
 
 #include <algorithm>
-#include <iostream>
+#include <istream>
 #include <numeric>
 #include <ranges>
 #include <vector>
 
+namespace {
+
 struct Machine {
-  int a_dx;
-  int a_dy;
-  int b_dx;
-  int b_dy;
-  int x;
-  int y;
+  std::int64_t a_dx;
+  std::int64_t a_dy;
+  std::int64_t b_dx;
+  std::int64_t b_dy;
+  std::int64_t x;
+  std::int64_t y;
 };
 
 static std::int64_t find_min_cost(const std::vector<Machine>& machines,
@@ -49,11 +52,25 @@ static std::int64_t find_min_cost(const std::vector<Machine>& machines,
   return cost;
 }
 
-int main() {
+static std::vector<Machine> extract_machines(std::istream& istream) {
   std::vector<Machine> machines;
-  for (const auto& v : extract_values(std::cin) | std::views::chunk(6)) {
+  for (auto&& chunk :
+       stream_values<std::int64_t>(istream) | std::views::chunk(6)) {
+    const auto v = take_array<6>(chunk);
     machines.emplace_back(v[0], v[1], v[2], v[3], v[4], v[5]);
   }
-  std::cout << find_min_cost(machines, 0) << "\n";
-  std::cout << find_min_cost(machines, 10'000'000'000'000) << "\n";
+  return machines;
+}
+
+static std::int64_t part_1(const std::vector<Machine>& machines) {
+  return find_min_cost(machines, 0);
 }
+
+static std::int64_t part_2(const std::vector<Machine>& machines) {
+  return find_min_cost(machines, 10'000'000'000'000);
+}
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(13, extract_machines, part_1, part_2);
@@ -1,17 +1,26 @@
 // https://adventofcode.com/2024/day/14
 
+#include "renderer.hpp"
 #include "shared.hpp"
+#include "solver.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
-#include <functional>
-#include <iostream>
+#include <cstdint>
+#include <istream>
+#include <limits>
 #include <numeric>
 #include <optional>
+#include <ostream>
 #include <ranges>
+#include <span>
+#include <string>
 #include <vector>
 
+namespace {
+
 template <typename T>
 T wrap(const T value, const T max) {
   const auto value_mod_max = value % max;
@@ -23,23 +32,29 @@ struct Robot {
   Vector2i velocity;
 };
 
-static void print_robots(const std::vector<Robot>& robots,
-                         const Vector2i& size) {
-  Grid grid{size, ' '};
+static void print_robots(Renderer& renderer,
+                         const std::vector<Robot>& robots) {
+  renderer.fill(' ');
   for (const auto& robot : robots) {
-    grid.location(robot.location) = '#';
+    renderer.set(robot.location, '#');
   }
-  std::cout << grid << "\n";
+  renderer.present();
 }
 
 static std::vector<Robot> tick(const std::vector<Robot>& robots,
-                               const Vector2i& size, const int ticks = 1) {
+                               const Vector2i& size,
+                               const std::int64_t ticks = 1) {
+  const auto wrap_axis = [&](const int location, const int velocity,
+                             const int axis_size) {
+    return static_cast<int>(wrap(location + ticks * velocity,
+                                 std::int64_t{axis_size}));
+  };
   std::vector<Robot> new_robots;
   for (const auto& robot : robots) {
-    Robot new_robot{robot.location + ticks * robot.velocity, robot.velocity};
-    new_robot.location.x = wrap(new_robot.location.x, size.x);
-    new_robot.location.y = wrap(new_robot.location.y, size.y);
-    new_robots.push_back(new_robot);
+    new_robots.push_back(
+        {{wrap_axis(robot.location.x, robot.velocity.x, size.x),
+          wrap_axis(robot.location.y, robot.velocity.y, size.y)},
+         robot.velocity});
   }
   return new_robots;
 }
@@ -51,42 +66,120 @@ static std::optional<std::size_t> get_quadrant_index(const Vector2i& location,
              : (location.x > size.x / 2) + 2 * (location.y > size.y / 2);
 }
 
-static int get_robot_safety_factor(const std::vector<Robot>& robots,
-                                   const Vector2i& size) {
-  std::array<int, 4> quadrant_counts{};
+// Product of the robot counts of the four quadrants, as decimal digits. The
+// counts are at most 2^32 each at any input size that fits in memory, so the
+// product always fits in 128 bits.
+static std::string get_robot_safety_factor(const std::vector<Robot>& robots,
+                                           const Vector2i& size) {
+  std::array<std::int64_t, 4> quadrant_counts{};
   for (const auto& robot : robots) {
     if (const auto qi = get_quadrant_index(robot.location, size)) {
       quadrant_counts[*qi]++;
     }
   }
-  return std::ranges::fold_left(quadrant_counts, 1, std::multiplies());
+  __extension__ typedef unsigned __int128 Product;
+  auto product = std::ranges::fold_left(
+      quadrant_counts, Product{1}, [](const Product lhs, const auto rhs) {
+        return lhs * static_cast<Product>(rhs);
+      });
+  std::string digits;
+  do {
+    digits.push_back(static_cast<char>('0' + product % 10));
+    product /= 10;
+  } while (product != 0);
+  std::ranges::reverse(digits);
+  return digits;
+}
+
+// Tick in [0, period) at which the robots' coordinates along axis, which
+// repeat with that period, are least spread out, as when the robots form a
+// picture. Only the first robots are sampled, which is plenty to find the
+// picture and keeps this O(period) on huge floors.
+static int find_alignment_tick(const std::vector<Robot>& robots,
+                               const int period, int Vector2i::*axis) {
+  static constexpr auto MAX_SAMPLED_ROBOTS = 1000uz;
+  const auto sampled_robots =
+      std::span{robots}.first(std::min(robots.size(), MAX_SAMPLED_ROBOTS));
+  const auto n_sampled = static_cast<std::int64_t>(sampled_robots.size());
+  auto best_tick = 0;
+  auto best_spread = std::numeric_limits<std::int64_t>::max();
+  for (auto tick = 0; tick < period; tick++) {
+    std::int64_t sum = 0;
+    std::int64_t sum_of_squares = 0;
+    for (const auto& robot : sampled_robots) {
+      const std::int64_t coordinate = wrap(
+          static_cast<std::int64_t>(robot.location.*axis) +
+              static_cast<std::int64_t>(tick) * (robot.velocity.*axis),
+          std::int64_t{period});
+      sum += coordinate;
+      sum_of_squares += coordinate * coordinate;
+    }
+    // n^2 times the variance
+    const auto spread = n_sampled * sum_of_squares - sum * sum;
+    if (spread < best_spread) {
+      best_spread = spread;
+      best_tick = tick;
+    }
+  }
+  return best_tick;
 }
 
-static int get_ticks_to_christmas_tree(const std::vector<Robot>& robots,
-                                       const Vector2i& size,
-                                       const Vector2i& alignment_index) {
-  const auto period_x = size.x / std::gcd(size.x, size.y);
-  for (auto x = 0; x < period_x; x++) {
-    const auto y = (alignment_index.x + x * size.x) / size.y;
-    const auto is_solution =
-        alignment_index.x + x * size.x == alignment_index.y + y * size.y;
-    if (is_solution) {
-      const auto ticks = alignment_index.x + x * size.x + 1;
-      print_robots(tick(robots, size, ticks), size);
+// first tick at which the robots align along both axes, found by the
+// Chinese remainder theorem over the floor's width and height
+static std::int64_t get_ticks_to_christmas_tree(
+    const std::vector<Robot>& robots, const Vector2i& size) {
+  const auto tick_x = find_alignment_tick(robots, size.x, &Vector2i::x);
+  const auto tick_y = find_alignment_tick(robots, size.y, &Vector2i::y);
+  const auto n_candidates = size.y / std::gcd(size.x, size.y);
+  for (auto x = 0; x < n_candidates; x++) {
+    const auto ticks = tick_x + std::int64_t{x} * size.x;
+    if (ticks % size.y == tick_y) {
       return ticks;
     }
   }
   return -1;
 }
 
-int main() {
+// the puzzle's floor; generated inputs give theirs in a size line
+static constexpr Vector2i PUZZLE_SIZE{101, 103};
+
+struct Floor {
+  Vector2i size;
   std::vector<Robot> robots;
-  for (const auto& v : extract_values(std::cin) | std::views::chunk(4)) {
-    robots.emplace_back(Vector2i{v[0], v[1]}, Vector2i{v[2], v[3]});
+};
+
+static Floor extract_floor(std::istream& istream) {
+  Floor floor{extract_size_line(istream, PUZZLE_SIZE), {}};
+  for (auto&& chunk : stream_values(istream) | std::views::chunk(4)) {
+    const auto v = take_array<4>(chunk);
+    floor.robots.emplace_back(Vector2i{v[0], v[1]}, Vector2i{v[2], v[3]});
   }
-  const Vector2i size{101, 103};
-  std::cout << get_robot_safety_factor(tick(robots, size, 100), size) << "\n";
-  const Vector2i alignment_index{67, 30};
-  std::cout << get_ticks_to_christmas_tree(robots, size, alignment_index)
-            << "\n";
+  return floor;
 }
+
+static std::string part_1(const Floor& floor) {
+  return get_robot_safety_factor(tick(floor.robots, floor.size, 100),
+                                 floor.size);
+}
+
+static std::int64_t part_2(const Floor& floor) {
+  return get_ticks_to_christmas_tree(floor.robots, floor.size);
+}
+
+// draws the robots at the tick part 2 finds
+static void replay(const Floor& floor, std::ostream& ostream) {
+  const auto ticks = get_ticks_to_christmas_tree(floor.robots, floor.size);
+  if (ticks < 0) {
+    return;
+  }
+  Renderer renderer{ostream, floor.size};
+  print_robots(renderer, tick(floor.robots, floor.size, ticks));
+}
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(14, extract_floor, part_1, part_2);
+
+[[maybe_unused]] static const auto registered_replay =
+    register_replay(14, extract_floor, replay);
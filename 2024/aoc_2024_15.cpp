@@ -1,9 +1,10 @@
 // https://adventofcode.com/2024/day/15
 
 #include "shared.hpp"
+#include "solver.hpp"
 
 #include <algorithm>
-#include <iostream>
+#include <istream>
 #include <optional>
 #include <ranges>
 #include <sstream>
@@ -13,6 +14,8 @@
 #include <utility>
 #include <vector>
 
+namespace {
+
 static std::stringstream get_stream_to_empty_line(std::istream& istream) {
   std::stringstream string_ss;
   std::string string;
@@ -221,24 +224,40 @@ static int get_box_gps_sum(const Grid& grid) {
   return gps_sum;
 }
 
-int main() {
-  auto grid_stream = get_stream_to_empty_line(std::cin);
+struct Warehouse {
+  Grid grid;
+  std::vector<Vector2i> directions;
+};
+
+static Warehouse extract_warehouse(std::istream& istream) {
+  auto grid_stream = get_stream_to_empty_line(istream);
   Grid grid{grid_stream};
-  auto wide_grid = widen_grid(grid);
-  const auto directions = std::views::istream<char>(std::cin) |
-                          std::views::transform(char_to_direction) |
-                          std::ranges::to<std::vector<Vector2i>>();
+  auto directions = std::views::istream<char>(istream) |
+                    std::views::transform(char_to_direction) |
+                    std::ranges::to<std::vector<Vector2i>>();
+  return {grid, directions};
+}
 
-  for (const auto& direction : directions) {
+static int part_1(const Warehouse& warehouse) {
+  auto grid = warehouse.grid;
+  for (const auto& direction : warehouse.directions) {
     const auto robot_location = std::find(grid.cbegin(), grid.cend(), '@');
     grid = tick(grid, robot_location, direction);
   }
-  std::cout << get_box_gps_sum(grid) << "\n";
+  return get_box_gps_sum(grid);
+}
 
-  for (const auto& direction : directions) {
+static int part_2(const Warehouse& warehouse) {
+  auto wide_grid = widen_grid(warehouse.grid);
+  for (const auto& direction : warehouse.directions) {
     const auto robot_location =
         std::find(wide_grid.cbegin(), wide_grid.cend(), '@');
     wide_grid = wide_tick(wide_grid, robot_location, direction);
   }
-  std::cout << get_box_gps_sum(wide_grid) << "\n";
+  return get_box_gps_sum(wide_grid);
 }
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(15, extract_warehouse, part_1, part_2);
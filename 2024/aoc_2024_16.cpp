@@ -1,45 +1,36 @@
 // https://adventofcode.com/2024/day/16
 
+#include "instrumentation.hpp"
+#include "search.hpp"
 #include "shared.hpp"
+#include "solver.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
-#include <iostream>
+#include <cstdint>
 #include <limits>
-#include <set>
-#include <stack>
-#include <vector>
+#include <span>
+
+namespace {
 
 struct Pose {
   Vector2i location;
   std::size_t direction_index;
-  int cost;
-  std::vector<Vector2i> locations;
+
+  bool operator==(const Pose&) const = default;
 };
 
 static constexpr auto COST_FORWARD = 1;
 static constexpr auto COST_TURN = 1000;
 
-static Pose walk_forward(const Pose& pose) {
-  return {pose.location + Grid::CARDINAL_DIRECTIONS[pose.direction_index],
-          pose.direction_index, pose.cost + COST_FORWARD, pose.locations};
-}
-
-static Pose walk_left(const Pose& pose) {
-  auto direction_index = pose.direction_index == 0
-                             ? Grid::CardinalDirection::END - 1
-                             : pose.direction_index - 1;
-  return {pose.location + Grid::CARDINAL_DIRECTIONS[direction_index],
-          direction_index, pose.cost + COST_TURN + COST_FORWARD,
-          pose.locations};
+static std::size_t turn_left(const std::size_t direction_index) {
+  return direction_index == 0 ? Grid::CardinalDirection::END - 1
+                              : direction_index - 1;
 }
 
-static Pose walk_right(const Pose& pose) {
-  auto direction_index =
-      (pose.direction_index + 1) % Grid::CardinalDirection::END;
-  return {pose.location + Grid::CARDINAL_DIRECTIONS[direction_index],
-          direction_index, pose.cost + COST_TURN + COST_FORWARD,
-          pose.locations};
+static std::size_t turn_right(const std::size_t direction_index) {
+  return (direction_index + 1) % Grid::CardinalDirection::END;
 }
 
 static bool is_wall(const Grid& grid, const Vector2i& location) {
@@ -50,47 +41,120 @@ static bool is_end(const Grid& grid, const Vector2i& location) {
   return grid.location(location) == 'E';
 }
 
-int main() {
-  Grid grid{std::cin};
-  std::stack<Pose> poses;
-  poses.emplace(std::find(grid.cbegin(), grid.cend(), 'S'),
-                Grid::CardinalDirection::EAST, 0);
-  Matrix<int> min_costs{grid.size(), std::numeric_limits<int>::max()};
-  auto min_cost = std::numeric_limits<int>::max();
-  std::set<Vector2i> min_locations;
-  while (!poses.empty()) {
-    auto pose = poses.top();
-    pose.locations.push_back(pose.location);
-    poses.pop();
-
-    if (is_wall(grid, pose.location)) {
-      continue;
-    }
+// walking forward, or turning left or right and then walking forward
+static std::int64_t step_cost(const Pose& pose, const Pose& next_pose) {
+  return pose.direction_index == next_pose.direction_index
+             ? COST_FORWARD
+             : COST_TURN + COST_FORWARD;
+}
 
-    const auto is_costlier_route =
-        pose.cost > min_cost ||
-        pose.cost - min_costs.location(pose.location) > COST_TURN;
-    if (is_costlier_route) {
-      continue;
-    }
-    min_costs.location(pose.location) = pose.cost;
-
-    if (is_end(grid, pose.location)) {
-      if (pose.cost < min_cost) {
-        min_locations.clear();
-        min_cost = pose.cost;
-      }
-      if (pose.cost == min_cost) {
-        std::copy(pose.locations.cbegin(), pose.locations.cend(),
-                  std::inserter(min_locations, min_locations.cend()));
-      }
-      continue;
+static void visit_next_poses(const Grid& grid, const Pose& pose,
+                             const auto& visit) {
+  for (const auto direction_index :
+       {pose.direction_index, turn_left(pose.direction_index),
+        turn_right(pose.direction_index)}) {
+    const auto location =
+        pose.location + Grid::CARDINAL_DIRECTIONS[direction_index];
+    if (!is_wall(grid, location)) {
+      visit(Pose{location, direction_index});
     }
+  }
+}
+
+// poses that reach pose in one step, i.e. visit_next_poses reversed
+static void visit_previous_poses(const Grid& grid, const Pose& pose,
+                                 const auto& visit) {
+  const auto location =
+      pose.location - Grid::CARDINAL_DIRECTIONS[pose.direction_index];
+  if (is_wall(grid, location)) {
+    return;
+  }
+  for (const auto direction_index :
+       {pose.direction_index, turn_left(pose.direction_index),
+        turn_right(pose.direction_index)}) {
+    visit(Pose{location, direction_index});
+  }
+}
+
+static auto make_search(const Grid& grid) {
+  const auto pose_index = [&grid](const Pose& pose) {
+    return grid.index(pose.location) * Grid::CardinalDirection::END +
+           pose.direction_index;
+  };
+  return Search<Pose, decltype(pose_index)>{
+      grid.n_locations() * Grid::CardinalDirection::END, pose_index};
+}
 
-    for (const auto& walk : {walk_left, walk_right, walk_forward}) {
-      poses.push(walk(pose));
+static Pose find_start_pose(const Grid& grid) {
+  return {std::find(grid.cbegin(), grid.cend(), 'S'),
+          Grid::CardinalDirection::EAST};
+}
+
+static std::array<Pose, Grid::CardinalDirection::END> get_end_poses(
+    const Grid& grid) {
+  const Vector2i end_location = std::find(grid.cbegin(), grid.cend(), 'E');
+  return {{{end_location, Grid::CardinalDirection::NORTH},
+           {end_location, Grid::CardinalDirection::EAST},
+           {end_location, Grid::CardinalDirection::SOUTH},
+           {end_location, Grid::CardinalDirection::WEST}}};
+}
+
+static std::int64_t part_1(const Grid& grid) {
+  auto search = make_search(grid);
+  const auto start_pose = find_start_pose(grid);
+  const auto end_pose = search.run(
+      SearchMode::DIJKSTRA, std::span{&start_pose, 1},
+      [&](const Pose& pose, const auto& visit) {
+        visit_next_poses(grid, pose, visit);
+      },
+      step_cost, [&](const Pose& pose) { return is_end(grid, pose.location); });
+  return end_pose ? search.distance(*end_pose) : -1;
+}
+
+// A location is on a minimum cost path if the cost from the start to one of
+// its poses plus the cost from that pose to the end is the minimum cost.
+static std::size_t part_2(const Grid& grid) {
+  auto search_from_start = make_search(grid);
+  const auto start_pose = find_start_pose(grid);
+  {
+    AOC_SCOPED_TIMER("search from start");
+    search_from_start.run(SearchMode::DIJKSTRA, std::span{&start_pose, 1},
+                          [&](const Pose& pose, const auto& visit) {
+                            visit_next_poses(grid, pose, visit);
+                          },
+                          step_cost);
+  }
+
+  const auto end_poses = get_end_poses(grid);
+  auto min_cost = std::numeric_limits<std::int64_t>::max();
+  for (const auto& end_pose : end_poses) {
+    min_cost = std::min(min_cost, search_from_start.distance(end_pose));
+  }
+
+  auto search_from_end = make_search(grid);
+  {
+    AOC_SCOPED_TIMER("search from end");
+    search_from_end.run(SearchMode::DIJKSTRA, std::span{end_poses},
+                        [&](const Pose& pose, const auto& visit) {
+                          visit_previous_poses(grid, pose, visit);
+                        },
+                        [](const Pose& pose, const Pose& previous_pose) {
+                          return step_cost(previous_pose, pose);
+                        });
+  }
+
+  LocationSet min_locations{grid.size()};
+  for (const auto& pose : search_from_start.reached()) {
+    const auto cost_to_end = search_from_end.distance(pose);
+    if (cost_to_end != search_from_end.UNREACHED &&
+        search_from_start.distance(pose) + cost_to_end == min_cost) {
+      min_locations.insert(pose.location);
     }
   }
-  std::cout << min_cost << "\n";
-  std::cout << min_locations.size() << "\n";
+  return min_locations.size();
 }
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(16, extract_grid, part_1, part_2);
@@ -1,15 +1,21 @@
 // https://adventofcode.com/2024/day/17
 
+#include "instrumentation.hpp"
 #include "shared.hpp"
+#include "solver.hpp"
 
 #include <algorithm>
 #include <array>
 #include <cstddef>
 #include <functional>
 #include <iostream>
+#include <optional>
 #include <ranges>
+#include <string>
 #include <vector>
 
+namespace {
+
 struct State {
   std::vector<std::uint64_t> registers;
   std::size_t instruction_pointer{0};
@@ -99,7 +105,7 @@ static Result opcode_bdv(const State& state, const std::uint64_t operand) {
   return {new_state, {}};
 }
 
-Result opcode_cdv(const State& state, const std::uint64_t operand) {
+static Result opcode_cdv(const State& state, const std::uint64_t operand) {
   auto new_state = state;
   new_state.registers[Register::C] =
       state.registers[Register::A] /
@@ -108,8 +114,9 @@ Result opcode_cdv(const State& state, const std::uint64_t operand) {
   return {new_state, {}};
 }
 
-std::vector<std::uint64_t> run_program(
+static std::vector<std::uint64_t> run_program(
     const State& initial_state, const std::vector<std::uint64_t>& program) {
+  AOC_COUNT("run_program calls");
   static const auto opcode_functions =
       std::to_array<std::function<Result(const State&, std::uint64_t)>>({
           opcode_adv,
@@ -126,6 +133,7 @@ std::vector<std::uint64_t> run_program(
   while (state.instruction_pointer < program.size()) {
     const auto opcode = program[state.instruction_pointer + 0];
     const auto operand = program[state.instruction_pointer + 1];
+    AOC_COUNT("instructions executed");
     const auto [new_state, output] =
         opcode_functions[static_cast<std::size_t>(opcode)](state, operand);
     state = new_state;
@@ -136,11 +144,10 @@ std::vector<std::uint64_t> run_program(
   return outputs;
 }
 
-void find_output_program(const State& initial_state,
-                         const std::vector<std::uint64_t>& program,
-                         const std::uint64_t initial_a,
-                         const std::uint64_t delta_a,
-                         const std::size_t n_outputs_check) {
+static std::uint64_t find_output_program(
+    const State& initial_state, const std::vector<std::uint64_t>& program,
+    const std::uint64_t initial_a, const std::uint64_t delta_a,
+    const std::size_t n_outputs_check) {
   auto state = initial_state;
   state.registers[Register::A] = initial_a;
   while (true) {
@@ -153,28 +160,41 @@ void find_output_program(const State& initial_state,
          std::ranges::to<std::vector<std::uint64_t>>());
     if (first_n_outputs_equal) {
       static auto last_register_a = state.registers[Register::A];
-      std::cout << state.registers[Register::A] << " "
+      std::clog << state.registers[Register::A] << " "
                 << state.registers[Register::A] - last_register_a << "\n";
       last_register_a = state.registers[Register::A];
     }
     if (outputs == program) {
-      std::cout << state.registers[Register::A] << "\n";
-      break;
+      return state.registers[Register::A];
     }
     state.registers[Register::A] += delta_a;
   }
 }
 
-int main() {
-  const auto values = extract_values(std::cin);
+struct Computer {
+  State state;
+  std::vector<std::uint64_t> program;
+};
+
+static Computer extract_computer(std::istream& istream) {
+  const auto values = extract_values<std::uint64_t>(istream);
   const State state{values | std::views::take(Register::END) |
                     std::ranges::to<std::vector<std::uint64_t>>()};
   const auto program = values | std::views::drop(Register::END) |
                        std::ranges::to<std::vector<std::uint64_t>>();
+  return {state, program};
+}
 
-  const auto outputs = run_program(state, program);
-  std::ranges::copy(outputs, std::ostream_iterator<int>(std::cout, ","));
-  std::cout << "\n";
+static std::string part_1(const Computer& computer) {
+  std::string outputs_string;
+  for (const auto output : run_program(computer.state, computer.program)) {
+    outputs_string += std::to_string(output) + ",";
+  }
+  return outputs_string;
+}
+
+static std::uint64_t part_2(const Computer& computer) {
+  const auto& [state, program] = computer;
 
   /*
   output to match program: 2,4,1,7,7,5,4,1,1,4,5,5,0,3,3,0
@@ -203,5 +223,10 @@ int main() {
   // find_output_program(state, program, 35184375080160, 4194304, 7);
 
   // result suggests new start and delta for register A
-  find_output_program(state, program, 35184391857376, 33554432, 16);
+  return find_output_program(state, program, 35184391857376, 33554432, 16);
 }
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(17, extract_computer, part_1, part_2);
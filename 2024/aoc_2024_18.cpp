@@ -1,89 +1,120 @@
 // https://adventofcode.com/2024/day/18
 
+#include "search.hpp"
 #include "shared.hpp"
+#include "solver.hpp"
 
-#include <iostream>
-#include <limits>
+#include <algorithm>
+#include <cstdlib>
+#include <istream>
+#include <optional>
 #include <ranges>
 #include <span>
-#include <stack>
 #include <vector>
 
-static int find_path(const Vector2i& grid_size,
-                     const std::span<Vector2i>& bytes,
-                     const Vector2i& start_location,
-                     const Vector2i& goal_location, const bool find_shortest) {
+namespace {
+
+static Grid drop_bytes(const Vector2i& grid_size,
+                       const std::span<const Vector2i>& bytes) {
   Grid grid{grid_size, ' '};
-  struct Location {
-    Vector2i location;
-    int cost;
-  };
-  auto min_cost = std::numeric_limits<int>::max();
-  Matrix<int> min_costs{grid.size(), std::numeric_limits<int>::max()};
-  std::stack<Location> locations;
-  locations.push({start_location, 0});
   for (const auto& byte : bytes) {
     grid.location(byte) = '#';
   }
+  return grid;
+}
 
-  while (!locations.empty()) {
-    const auto location = locations.top();
-    locations.pop();
-
-    if (!grid.is_inside(location.location)) {
-      continue;
-    }
+// A* search with the Manhattan distance to the goal as heuristic
+static std::optional<int> find_shortest_path(const Grid& grid,
+                                             const Vector2i& start_location,
+                                             const Vector2i& goal_location) {
+  const auto location_index = [&grid](const Vector2i& location) {
+    return grid.index(location);
+  };
+  Search<Vector2i, decltype(location_index)> search{grid.n_locations(),
+                                                    location_index};
+  const auto goal = search.run(
+      SearchMode::A_STAR, std::span{&start_location, 1},
+      [&](const Vector2i& location, const auto& visit) {
+        for (const auto& direction : Grid::CARDINAL_DIRECTIONS) {
+          const auto next_location = location + direction;
+          if (grid.is_inside(next_location) &&
+              grid.location(next_location) != '#') {
+            visit(next_location);
+          }
+        }
+      },
+      [](const Vector2i&, const Vector2i&) { return 1; },
+      [&](const Vector2i& location) { return location == goal_location; },
+      [&](const Vector2i& location) {
+        return std::abs(goal_location.x - location.x) +
+               std::abs(goal_location.y - location.y);
+      });
+  if (!goal || grid.location(start_location) == '#') {
+    return {};
+  }
+  return static_cast<int>(search.distance(*goal));
+}
 
-    if (grid.location(location.location) == '#') {
-      continue;
-    }
+// the puzzle's memory space; generated inputs give theirs in a size line
+static constexpr Vector2i PUZZLE_SIZE{71, 71};
+static constexpr Vector2i START_LOCATION{0, 0};
+static constexpr auto MIN_BYTES = 1024uz;
 
-    const auto is_costlier_route =
-        location.cost > min_cost ||
-        location.cost >= min_costs.location(location.location);
-    if (is_costlier_route) {
-      continue;
-    }
-    min_costs.location(location.location) = location.cost;
+struct MemorySpace {
+  Vector2i size;
+  std::vector<Vector2i> bytes;
 
-    if (location.location == goal_location) {
-      min_cost = std::min(min_cost, location.cost);
-      if (find_shortest) {
-        continue;
-      } else {
-        break;
-      }
-    }
+  Vector2i goal_location() const { return {size.x - 1, size.y - 1}; }
+};
 
-    for (const auto& direction : Grid::CARDINAL_DIRECTIONS) {
-      locations.push({location.location + direction, location.cost + 1});
-    }
+static MemorySpace extract_memory_space(std::istream& istream) {
+  MemorySpace memory_space{extract_size_line(istream, PUZZLE_SIZE), {}};
+  for (auto&& chunk : stream_values(istream) | std::views::chunk(2)) {
+    const auto v = take_array<2>(chunk);
+    memory_space.bytes.emplace_back(v[0], v[1]);
   }
-  return min_cost;
+  return memory_space;
 }
 
-int main() {
-  std::vector<Vector2i> bytes;
-  for (const auto v : extract_values(std::cin) | std::views::chunk(2)) {
-    bytes.emplace_back(v[0], v[1]);
-  }
-
-  const Vector2i grid_size{71, 71};
-  const Vector2i start_location{0, 0};
-  const auto goal_location = grid_size - Vector2i{1, 1};
-
-  constexpr auto min_bytes = 1024uz;
-  const auto cost = find_path(grid_size, bytes | std::views::take(min_bytes),
-                              start_location, goal_location, true);
-  std::cout << cost << "\n";
+static int part_1(const MemorySpace& memory_space) {
+  const auto grid = drop_bytes(
+      memory_space.size, memory_space.bytes | std::views::take(MIN_BYTES));
+  return find_shortest_path(grid, START_LOCATION, memory_space.goal_location())
+      .value_or(-1);
+}
 
-  for (const auto n_bytes : std::views::iota(min_bytes, bytes.size())) {
-    const auto has_path =
-        find_path(grid_size, bytes | std::views::take(n_bytes), start_location,
-                  goal_location, false) != std::numeric_limits<int>::max();
-    if (!has_path) {
-      std::cout << bytes[n_bytes - 1] << "\n";
-      break;
+// Paths only get blocked by more bytes, so binary search the byte count. One
+// mask of free locations is moved between probed byte counts by dropping or
+// lifting only the bytes in between, and one search is reused for every
+// probe.
+static Vector2i part_2(const MemorySpace& memory_space) {
+  const auto& bytes = memory_space.bytes;
+  BitGrid free_locations{memory_space.size};
+  free_locations.fill();
+  BitGridSearch search{memory_space.size};
+  auto n_dropped = 0uz;
+  const auto has_path_after = [&](const std::size_t n_bytes) {
+    for (; n_dropped < n_bytes; n_dropped++) {
+      free_locations.set(bytes[n_dropped], false);
+    }
+    for (; n_dropped > n_bytes; n_dropped--) {
+      free_locations.set(bytes[n_dropped - 1]);
     }
+    return search
+        .find_distance(free_locations, START_LOCATION,
+                       memory_space.goal_location())
+        .has_value();
+  };
+  const auto n_bytes_range = std::views::iota(MIN_BYTES, bytes.size());
+  const auto n_bytes_it =
+      std::ranges::partition_point(n_bytes_range, has_path_after);
+  if (n_bytes_it == n_bytes_range.end()) {
+    return {-1, -1};
   }
+  return bytes[*n_bytes_it - 1];
 }
+
+}  // namespace
+
+[[maybe_unused]] static const auto registered =
+    register_solver(18, extract_memory_space, part_1, part_2);
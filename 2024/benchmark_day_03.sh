@@ -0,0 +1,31 @@
+#!/bin/sh
+# Compares the day 3 scanner with the std::regex solver it replaced, on
+# generated instructions and on random noise of printable characters.
+#
+# usage: benchmark_day_03.sh BUILD_DIR SIZE_MB [--repeat N]
+#
+# BUILD_DIR should be configured with -DCMAKE_BUILD_TYPE=Release.
+
+set -e
+
+if [ $# -lt 2 ]; then
+  echo "usage: $0 BUILD_DIR SIZE_MB [--repeat N]" >&2
+  exit 1
+fi
+
+build_dir=$1
+size_mb=$2
+shift 2
+cmake --build "$build_dir" --target aoc_2024 aoc_2024_generate
+
+input_dir=$(mktemp -d)
+trap 'rm -rf "$input_dir"' EXIT
+
+# an instruction with its noise is about 16 characters
+"$build_dir/aoc_2024_generate" 3 $((size_mb * 65536)) \
+  > "$input_dir/instructions.txt"
+LC_ALL=C tr -dc "a-z0-9(),' " < /dev/urandom | head -c $((size_mb << 20)) \
+  > "$input_dir/noise.txt"
+
+"$build_dir/aoc_2024" --variants "$@" "3:$input_dir/instructions.txt" \
+  "3:$input_dir/noise.txt"
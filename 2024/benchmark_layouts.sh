@@ -0,0 +1,25 @@
+#!/bin/sh
+# Compares the Matrix storage layouts by running the same jobs through each
+# layout's runner.
+#
+# usage: benchmark_layouts.sh BUILD_DIR [--repeat N] DAY:INPUT_FILE...
+#
+# BUILD_DIR must be configured with -DAOC_LAYOUT_RUNNERS=ON and
+# -DCMAKE_BUILD_TYPE=Release.
+
+set -e
+
+if [ $# -lt 2 ]; then
+  echo "usage: $0 BUILD_DIR [--repeat N] DAY:INPUT_FILE..." >&2
+  exit 1
+fi
+
+build_dir=$1
+shift
+cmake --build "$build_dir" --target aoc_2024_row_major aoc_2024_tiled \
+  aoc_2024_morton
+
+for layout in row_major tiled morton; do
+  echo "== $layout"
+  "$build_dir/aoc_2024_$layout" "$@"
+done
@@ -0,0 +1,18 @@
+// Entry point of the single day executables: solves the day linked into the
+// executable for the input on stdin.
+
+#include "instrumentation.hpp"
+#include "solver.hpp"
+
+#include <iostream>
+
+int main() {
+  for (const auto& [day, solver] : solvers()) {
+    const auto solution = solver(std::cin);
+    std::cout << solution.part_1 << "\n";
+    std::cout << solution.part_2 << "\n";
+  }
+  if constexpr (IS_INSTRUMENTATION_ENABLED) {
+    print_instrumentation_report(std::clog);
+  }
+}
@@ -0,0 +1,498 @@
+// Writes a synthetic, well-formed input for one day to stdout, for finding
+// where solvers stop scaling. SCALE means something different per day, see
+// GENERATORS; run without arguments for the list. The same DAY, SCALE and
+// SEED always give the same input.
+//
+// usage: aoc_2024_generate DAY SCALE [SEED]
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using Rng = std::mt19937_64;
+
+static std::int64_t uniform(Rng& rng, const std::int64_t min,
+                            const std::int64_t max) {
+  return std::uniform_int_distribution<std::int64_t>{min, max}(rng);
+}
+
+static bool chance(Rng& rng, const double probability) {
+  return std::bernoulli_distribution{probability}(rng);
+}
+
+// grids are at least 5x5 so there is room for a border and some content
+static std::size_t grid_side(const std::size_t scale) {
+  return std::max(scale, std::size_t{5});
+}
+
+// rows of side random chars, each char from chars with the given weights
+static void generate_grid(std::ostream& ostream, const std::size_t side,
+                          const std::string_view chars,
+                          const std::vector<double>& weights, Rng& rng) {
+  std::discrete_distribution<std::size_t> char_index{weights.cbegin(),
+                                                     weights.cend()};
+  std::string row(side, ' ');
+  for (auto y = 0uz; y < side; y++) {
+    for (auto& c : row) {
+      c = chars[char_index(rng)];
+    }
+    ostream << row << "\n";
+  }
+}
+
+static void print_rows(std::ostream& ostream,
+                       const std::vector<std::string>& rows) {
+  for (const auto& row : rows) {
+    ostream << row << "\n";
+  }
+}
+
+// SCALE lines of two location IDs, half of the right ones from the left
+static void generate_01(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  std::vector<std::int64_t> lefts(scale);
+  for (auto& left : lefts) {
+    left = uniform(rng, 10000, 99999);
+  }
+  for (const auto left : lefts) {
+    const auto right = chance(rng, 0.5)
+                           ? lefts[static_cast<std::size_t>(uniform(
+                                 rng, 0, static_cast<std::int64_t>(scale) - 1))]
+                           : uniform(rng, 10000, 99999);
+    ostream << left << "   " << right << "\n";
+  }
+}
+
+// SCALE reports of 5 to 8 levels, monotone with steps of 1 to 3 except for
+// an occasional bad level
+static void generate_02(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  for (auto report = 0uz; report < scale; report++) {
+    const auto n_levels = uniform(rng, 5, 8);
+    const auto sign = chance(rng, 0.5) ? 1 : -1;
+    auto level = uniform(rng, 30, 70);
+    for (auto level_index = 0; level_index < n_levels; level_index++) {
+      const auto is_bad = chance(rng, 0.05);
+      ostream << (level_index == 0 ? "" : " ")
+              << (is_bad ? uniform(rng, 1, 99) : level);
+      level += sign * uniform(rng, 1, 3);
+    }
+    ostream << "\n";
+  }
+}
+
+// SCALE instructions, valid or corrupted, between runs of noise
+static void generate_03(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  static constexpr std::string_view NOISE =
+      "!@#$%^&*()[]{}<>?,;:' +-_/abcdefhilmnortuwy0123456789";
+  static constexpr auto CORRUPTED = std::to_array<std::string_view>(
+      {"mul[", "mul(", "mul (", "mul(,", "do(", "don't", "mul(4*", "mul)"});
+  auto line_length = 0uz;
+  for (auto instruction = 0uz; instruction < scale; instruction++) {
+    std::string token;
+    const auto kind = uniform(rng, 0, 9);
+    if (kind < 6) {
+      token = "mul(" + std::to_string(uniform(rng, 0, 999)) + "," +
+              std::to_string(uniform(rng, 0, 999)) + ")";
+    } else if (kind == 6) {
+      token = "do()";
+    } else if (kind == 7) {
+      token = "don't()";
+    } else {
+      token = CORRUPTED[static_cast<std::size_t>(
+          uniform(rng, 0, CORRUPTED.size() - 1))];
+    }
+    const auto n_noise = uniform(rng, 0, 8);
+    for (auto noise = 0; noise < n_noise; noise++) {
+      token += NOISE[static_cast<std::size_t>(
+          uniform(rng, 0, NOISE.size() - 1))];
+    }
+    ostream << token;
+    line_length += token.size();
+    if (line_length >= 3000) {
+      ostream << "\n";
+      line_length = 0;
+    }
+  }
+  ostream << "\n";
+}
+
+// SCALE x SCALE grid of XMAS letters
+static void generate_04(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  generate_grid(ostream, grid_side(scale), "XMAS", {1, 1, 1, 1}, rng);
+}
+
+// page ordering rules for every pair of 90 pages, then SCALE updates of 3 to
+// 23 distinct pages, a third of them already in order
+static void generate_05(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  std::vector<int> pages(90);
+  std::iota(pages.begin(), pages.end(), 10);
+  std::ranges::shuffle(pages, rng);
+  for (auto before = 0uz; before < pages.size(); before++) {
+    for (auto after = before + 1; after < pages.size(); after++) {
+      ostream << pages[before] << "|" << pages[after] << "\n";
+    }
+  }
+  ostream << "\n";
+  std::vector<std::size_t> page_indices(pages.size());
+  std::iota(page_indices.begin(), page_indices.end(), 0uz);
+  for (auto update = 0uz; update < scale; update++) {
+    const auto n_pages = static_cast<std::size_t>(2 * uniform(rng, 1, 11) + 1);
+    std::ranges::shuffle(page_indices, rng);
+    std::vector<std::size_t> update_indices{
+        page_indices.cbegin(),
+        page_indices.cbegin() + static_cast<std::ptrdiff_t>(n_pages)};
+    if (chance(rng, 1.0 / 3)) {
+      std::ranges::sort(update_indices);
+    }
+    for (auto page = 0uz; page < n_pages; page++) {
+      ostream << (page == 0 ? "" : ",") << pages[update_indices[page]];
+    }
+    ostream << "\n";
+  }
+}
+
+// SCALE x SCALE lab with 2% obstructions and the guard in the middle
+static void generate_06(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  const auto side = grid_side(scale);
+  std::vector<std::string> rows(side, std::string(side, '.'));
+  for (auto& row : rows) {
+    for (auto& c : row) {
+      c = chance(rng, 0.02) ? '#' : '.';
+    }
+  }
+  rows[side / 2][side / 2] = '^';
+  print_rows(ostream, rows);
+}
+
+// SCALE equations of 3 to 12 operands, half of them solvable with +, * and
+// ||, results below 10^15
+static void generate_07(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  static constexpr std::int64_t MAX_RESULT = 1'000'000'000'000'000;
+  for (auto equation = 0uz; equation < scale; equation++) {
+    const auto n_operands = uniform(rng, 3, 12);
+    std::vector<std::int64_t> operands;
+    std::int64_t result = 0;
+    for (auto operand_index = 0; operand_index < n_operands; operand_index++) {
+      const auto operand = uniform(rng, 1, 999);
+      operands.push_back(operand);
+      if (operand_index == 0) {
+        result = operand;
+        continue;
+      }
+      const auto concatenated =
+          std::stoll(std::to_string(result) + std::to_string(operand));
+      const auto op = uniform(rng, 0, 2);
+      if (op == 1 && result <= MAX_RESULT / operand) {
+        result *= operand;
+      } else if (op == 2 && result <= MAX_RESULT / 1000) {
+        result = concatenated;
+      } else {
+        result += operand;
+      }
+    }
+    if (chance(rng, 0.5)) {
+      result += uniform(rng, 1, 9);
+    }
+    ostream << result << ":";
+    for (const auto operand : operands) {
+      ostream << " " << operand;
+    }
+    ostream << "\n";
+  }
+}
+
+// SCALE x SCALE map with 0.5% antennae of 62 frequencies
+static void generate_08(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  static constexpr std::string_view FREQUENCIES =
+      "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  const auto side = grid_side(scale);
+  std::string row(side, '.');
+  for (auto y = 0uz; y < side; y++) {
+    for (auto& c : row) {
+      c = chance(rng, 0.005) ? FREQUENCIES[static_cast<std::size_t>(uniform(
+                                   rng, 0, FREQUENCIES.size() - 1))]
+                             : '.';
+    }
+    ostream << row << "\n";
+  }
+}
+
+// disk map of SCALE digits, files of 1 to 9 blocks and gaps of 0 to 9
+static void generate_09(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  std::string disk_map(std::max(scale, std::size_t{1}), '0');
+  for (auto digit_index = 0uz; digit_index < disk_map.size(); digit_index++) {
+    const auto is_file = digit_index % 2 == 0;
+    disk_map[digit_index] =
+        static_cast<char>('0' + uniform(rng, is_file ? 1 : 0, 9));
+  }
+  ostream << disk_map << "\n";
+}
+
+// SCALE x SCALE map of diagonal slopes from 0 to 9 and back, with 5% noise
+static void generate_10(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  const auto side = grid_side(scale);
+  std::string row(side, '0');
+  for (auto y = 0uz; y < side; y++) {
+    for (auto x = 0uz; x < side; x++) {
+      const auto phase = static_cast<int>((x + y) % 18);
+      row[x] = static_cast<char>(
+          '0' + (chance(rng, 0.05) ? uniform(rng, 0, 9) : std::abs(phase - 9)));
+    }
+    ostream << row << "\n";
+  }
+}
+
+// SCALE stones below 10^6
+static void generate_11(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  for (auto stone = 0uz; stone < std::max(scale, std::size_t{1}); stone++) {
+    ostream << (stone == 0 ? "" : " ") << uniform(rng, 0, 999'999);
+  }
+  ostream << "\n";
+}
+
+// SCALE x SCALE garden of 4x4 blocks of 26 plants, 10% of plots replanted
+static void generate_12(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  const auto side = grid_side(scale);
+  const auto n_block_columns = (side + 3) / 4;
+  std::vector<char> block_plants(n_block_columns);
+  std::string row(side, 'A');
+  for (auto y = 0uz; y < side; y++) {
+    if (y % 4 == 0) {
+      for (auto& plant : block_plants) {
+        plant = static_cast<char>('A' + uniform(rng, 0, 25));
+      }
+    }
+    for (auto x = 0uz; x < side; x++) {
+      row[x] = chance(rng, 0.1) ? static_cast<char>('A' + uniform(rng, 0, 25))
+                                : block_plants[x / 4];
+    }
+    ostream << row << "\n";
+  }
+}
+
+// SCALE claw machines, half of them with a prize reachable by button presses
+static void generate_13(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  for (auto machine = 0uz; machine < scale; machine++) {
+    const auto ax = uniform(rng, 10, 99);
+    const auto ay = uniform(rng, 10, 99);
+    const auto bx = uniform(rng, 10, 99);
+    auto by = uniform(rng, 10, 99);
+    while (ax * by == ay * bx) {
+      // like the puzzle input, the buttons are never parallel
+      by = uniform(rng, 10, 99);
+    }
+    const auto is_solvable = chance(rng, 0.5);
+    const auto a_presses = uniform(rng, 0, 100);
+    const auto b_presses = uniform(rng, 0, 100);
+    const auto prize_x = is_solvable ? a_presses * ax + b_presses * bx
+                                     : uniform(rng, 1000, 20000);
+    const auto prize_y = is_solvable ? a_presses * ay + b_presses * by
+                                     : uniform(rng, 1000, 20000);
+    ostream << (machine == 0 ? "" : "\n") << "Button A: X+" << ax << ", Y+"
+            << ay << "\nButton B: X+" << bx << ", Y+" << by
+            << "\nPrize: X=" << prize_x << ", Y=" << prize_y << "\n";
+  }
+}
+
+// a size line, then SCALE robots on a floor of about 20 tiles per robot, at
+// least the puzzle's 101x103; the sides are odd and coprime like the
+// puzzle's
+static void generate_14(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  const auto side =
+      static_cast<std::int64_t>(std::sqrt(20.0 * static_cast<double>(scale)));
+  const auto width = std::max(side | 1, std::int64_t{101});
+  const auto height = width + 2;
+  ostream << "size=" << width << "," << height << "\n";
+  for (auto robot = 0uz; robot < scale; robot++) {
+    ostream << "p=" << uniform(rng, 0, width - 1) << ","
+            << uniform(rng, 0, height - 1) << " v=" << uniform(rng, -99, 99)
+            << "," << uniform(rng, -99, 99) << "\n";
+  }
+}
+
+// SCALE x SCALE walled warehouse with 10% walls and 25% boxes, the robot in
+// the middle, then SCALE^2 moves
+static void generate_15(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  const auto side = grid_side(scale);
+  std::vector<std::string> rows(side, std::string(side, '#'));
+  for (auto y = 1uz; y + 1 < side; y++) {
+    for (auto x = 1uz; x + 1 < side; x++) {
+      const auto roll = uniform(rng, 0, 99);
+      rows[y][x] = roll < 10 ? '#' : roll < 35 ? 'O' : '.';
+    }
+  }
+  rows[side / 2][side / 2] = '@';
+  print_rows(ostream, rows);
+  ostream << "\n";
+  static constexpr std::string_view MOVES = "^>v<";
+  std::string line;
+  for (auto move = 0uz; move < side * side; move++) {
+    line += MOVES[static_cast<std::size_t>(uniform(rng, 0, 3))];
+    if (line.size() == 1000) {
+      ostream << line << "\n";
+      line.clear();
+    }
+  }
+  if (!line.empty()) {
+    ostream << line << "\n";
+  }
+}
+
+// SCALE x SCALE maze carved by the sidewinder algorithm, with 5% of the
+// remaining inner walls knocked out so there are many equal paths
+static void generate_16(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  const auto side = grid_side(scale) | 1;
+  std::vector<std::string> rows(side, std::string(side, '#'));
+  for (auto y = 1uz; y + 1 < side; y += 2) {
+    auto run_begin = 1uz;
+    for (auto x = 1uz; x + 1 < side; x += 2) {
+      rows[y][x] = '.';
+      const auto is_last_column = x + 3 >= side;
+      const auto close_run = y > 1 && (is_last_column || chance(rng, 0.5));
+      if (close_run) {
+        // open the run upwards from one of its cells
+        const auto up_x =
+            run_begin + 2 * static_cast<std::size_t>(uniform(
+                                rng, 0, static_cast<std::int64_t>(
+                                            (x - run_begin) / 2)));
+        rows[y - 1][up_x] = '.';
+        run_begin = x + 2;
+      } else if (!is_last_column) {
+        rows[y][x + 1] = '.';
+      }
+    }
+  }
+  for (auto y = 1uz; y + 1 < side; y++) {
+    for (auto x = 1uz; x + 1 < side; x++) {
+      if (rows[y][x] == '#' && (x + y) % 2 == 1 && chance(rng, 0.05)) {
+        rows[y][x] = '.';
+      }
+    }
+  }
+  rows[side - 2][1] = 'S';
+  rows[1][side - 2] = 'E';
+  print_rows(ostream, rows);
+}
+
+// the usual shape of the day 17 program, with register A of 3 * SCALE bits
+static void generate_17(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  const auto n_bits = std::min(3 * std::max(scale, std::size_t{1}), 63uz);
+  const auto a = uniform(rng, std::int64_t{1} << (n_bits - 1),
+                         (std::int64_t{1} << n_bits) - 1);
+  ostream << "Register A: " << a << "\nRegister B: 0\nRegister C: 0\n\n"
+          << "Program: 2,4,1," << uniform(rng, 1, 7) << ",7,5,1,"
+          << uniform(rng, 1, 7) << ",4," << uniform(rng, 0, 7)
+          << ",5,5,0,3,3,0\n";
+}
+
+// a size line, then SCALE distinct bytes on a square memory space about two
+// thirds full, at least the puzzle's 71x71, never on the start or exit
+static void generate_18(std::ostream& ostream, const std::size_t scale,
+                        Rng& rng) {
+  const auto side = std::max(
+      static_cast<int>(std::sqrt(1.5 * static_cast<double>(scale))), 71);
+  std::vector<std::pair<int, int>> locations;
+  for (auto y = 0; y < side; y++) {
+    for (auto x = 0; x < side; x++) {
+      const auto is_start_or_exit =
+          (x == 0 && y == 0) || (x == side - 1 && y == side - 1);
+      if (!is_start_or_exit) {
+        locations.emplace_back(x, y);
+      }
+    }
+  }
+  std::ranges::shuffle(locations, rng);
+  locations.resize(std::min(scale, locations.size()));
+  ostream << "size=" << side << "," << side << "\n";
+  for (const auto& [x, y] : locations) {
+    ostream << x << "," << y << "\n";
+  }
+}
+
+struct Generator {
+  const char* scale_meaning;
+  void (*generate)(std::ostream& ostream, std::size_t scale, Rng& rng);
+};
+
+static const std::map<int, Generator> GENERATORS{
+    {1, {"lines", generate_01}},
+    {2, {"reports", generate_02}},
+    {3, {"instructions", generate_03}},
+    {4, {"grid side", generate_04}},
+    {5, {"updates", generate_05}},
+    {6, {"grid side", generate_06}},
+    {7, {"equations", generate_07}},
+    {8, {"grid side", generate_08}},
+    {9, {"disk map digits", generate_09}},
+    {10, {"grid side", generate_10}},
+    {11, {"stones", generate_11}},
+    {12, {"grid side", generate_12}},
+    {13, {"claw machines", generate_13}},
+    {14, {"robots", generate_14}},
+    {15, {"grid side", generate_15}},
+    {16, {"grid side", generate_16}},
+    {17, {"octal digits of register A", generate_17}},
+    {18, {"bytes", generate_18}},
+};
+
+template <typename T>
+static std::optional<T> parse_value(const std::string_view string) {
+  T value;
+  const auto [end, error] =
+      std::from_chars(string.data(), string.data() + string.size(), value);
+  if (error != std::errc{} || end != string.data() + string.size()) {
+    return {};
+  }
+  return value;
+}
+
+}  // namespace
+
+int main(const int argc, const char* const argv[]) {
+  const auto day = argc >= 3 ? parse_value<int>(argv[1]) : std::nullopt;
+  const auto scale =
+      argc >= 3 ? parse_value<std::size_t>(argv[2]) : std::nullopt;
+  const auto seed =
+      argc >= 4 ? parse_value<std::uint64_t>(argv[3]) : std::uint64_t{1};
+  if (!day || !GENERATORS.contains(*day) || !scale || !seed || argc > 4) {
+    std::cerr << "usage: " << argv[0] << " DAY SCALE [SEED]\n";
+    for (const auto& [generator_day, generator] : GENERATORS) {
+      std::cerr << "  day " << generator_day << ": SCALE "
+                << generator.scale_meaning << "\n";
+    }
+    return 1;
+  }
+  std::ios::sync_with_stdio(false);
+  Rng rng{*seed};
+  GENERATORS.at(*day).generate(std::cout, *scale, rng);
+  return std::cout ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+#include "instrumentation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct TimerTotals {
+  std::int64_t n_calls = 0;
+  Clock::duration total{};
+};
+
+struct TraceEvent {
+  const char* name;
+  int thread_index;
+  Clock::time_point start;
+  Clock::duration duration;
+};
+
+// events beyond this are only counted in the report, to bound memory
+constexpr std::size_t MAX_TRACE_EVENTS = 1 << 20;
+
+struct Instrumentation {
+  std::mutex mutex;
+  std::map<std::string, std::atomic<std::int64_t>, std::less<>> counters;
+  std::map<std::string, TimerTotals, std::less<>> timer_totals;
+  std::vector<TraceEvent> trace_events;
+  const Clock::time_point start_time = Clock::now();
+  std::atomic<int> n_threads = 0;
+};
+
+Instrumentation& instrumentation() {
+  static Instrumentation instance;
+  return instance;
+}
+
+int thread_index() {
+  thread_local const int index = instrumentation().n_threads++;
+  return index;
+}
+
+double to_us(const Clock::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+}  // namespace
+
+std::atomic<std::int64_t>& instrumentation_counter(const char* name) {
+  auto& state = instrumentation();
+  const std::lock_guard lock{state.mutex};
+  return state.counters.try_emplace(name, 0).first->second;
+}
+
+void record_timer_event(const char* name, const Clock::time_point start,
+                        const Clock::time_point end) {
+  auto& state = instrumentation();
+  const auto index = thread_index();
+  const std::lock_guard lock{state.mutex};
+  auto& totals = state.timer_totals[name];
+  totals.n_calls++;
+  totals.total += end - start;
+  if (state.trace_events.size() < MAX_TRACE_EVENTS) {
+    state.trace_events.push_back({name, index, start, end - start});
+  }
+}
+
+void print_instrumentation_report(std::ostream& ostream) {
+  auto& state = instrumentation();
+  const std::lock_guard lock{state.mutex};
+  ostream << std::fixed << std::setprecision(3);
+  for (const auto& [name, counter] : state.counters) {
+    // counters of other days stay registered after a reset
+    if (counter.load() != 0) {
+      ostream << "  counter " << name << ": " << counter.load() << "\n";
+    }
+  }
+  for (const auto& [name, totals] : state.timer_totals) {
+    ostream << "  timer " << name << ": " << totals.n_calls << " calls, "
+            << to_us(totals.total) / 1000 << " ms\n";
+  }
+}
+
+void reset_instrumentation_report() {
+  auto& state = instrumentation();
+  const std::lock_guard lock{state.mutex};
+  for (auto& [name, counter] : state.counters) {
+    counter = 0;
+  }
+  state.timer_totals.clear();
+}
+
+void write_chrome_trace(std::ostream& ostream) {
+  auto& state = instrumentation();
+  const std::lock_guard lock{state.mutex};
+  // names are string literals from solver code, so they need no escaping
+  ostream << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  auto separator = "\n";
+  for (const auto& event : state.trace_events) {
+    ostream << separator << "{\"name\":\"" << event.name
+            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread_index
+            << ",\"ts\":" << to_us(event.start - state.start_time)
+            << ",\"dur\":" << to_us(event.duration) << "}";
+    separator = ",\n";
+  }
+  const auto end_us = to_us(Clock::now() - state.start_time);
+  for (const auto& [name, counter] : state.counters) {
+    ostream << separator << "{\"name\":\"" << name
+            << "\",\"ph\":\"C\",\"pid\":1,\"ts\":" << end_us
+            << ",\"args\":{\"value\":" << counter.load() << "}}";
+    separator = ",\n";
+  }
+  ostream << "\n]}\n";
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Hot-path instrumentation: named counters and scoped timers, summarized by
+// a per-run report and optionally exported as Chrome trace events (see
+// chrome://tracing or https://ui.perfetto.dev). Use the AOC_* macros in
+// solver code; they compile to nothing unless AOC_INSTRUMENTATION is defined,
+// so they can stay in the hot loops.
+//
+//   AOC_SCOPED_TIMER("walk");     // times the enclosing scope
+//   AOC_COUNT("walk calls");      // adds 1 to a counter
+//   AOC_COUNT_N("bytes", size);   // adds size to a counter
+//
+// Names must be string literals. Counters and timers may be used from any
+// thread.
+
+#ifdef AOC_INSTRUMENTATION
+inline constexpr bool IS_INSTRUMENTATION_ENABLED = true;
+#else
+inline constexpr bool IS_INSTRUMENTATION_ENABLED = false;
+#endif
+
+// counter of name, registered on first use
+std::atomic<std::int64_t>& instrumentation_counter(const char* name);
+
+void record_timer_event(const char* name,
+                        std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::time_point end);
+
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(const char* name)
+      : name{name}, start{std::chrono::steady_clock::now()} {}
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+  ~ScopedTimer() {
+    record_timer_event(name, start, std::chrono::steady_clock::now());
+  }
+
+ private:
+  const char* name;
+  std::chrono::steady_clock::time_point start;
+};
+
+// Non-zero counter values and timer call counts and totals since the last
+// reset, one line each, sorted by name.
+void print_instrumentation_report(std::ostream& ostream);
+void reset_instrumentation_report();
+
+// Every timer event since the start of the program (up to a limit) as Chrome
+// trace JSON, plus the final counter values.
+void write_chrome_trace(std::ostream& ostream);
+
+#define AOC_INSTRUMENTATION_CONCAT_(a, b) a##b
+#define AOC_INSTRUMENTATION_CONCAT(a, b) AOC_INSTRUMENTATION_CONCAT_(a, b)
+
+#ifdef AOC_INSTRUMENTATION
+#define AOC_SCOPED_TIMER(name) \
+  const ScopedTimer AOC_INSTRUMENTATION_CONCAT(aoc_timer_, __LINE__){name}
+#define AOC_COUNT_N(name, n)                                  \
+  do {                                                        \
+    static auto& aoc_counter = instrumentation_counter(name); \
+    aoc_counter.fetch_add(static_cast<std::int64_t>(n),       \
+                          std::memory_order_relaxed);         \
+  } while (false)
+#else
+#define AOC_SCOPED_TIMER(name) static_assert(true)
+#define AOC_COUNT_N(name, n) \
+  do {                       \
+  } while (false)
+#endif
+
+#define AOC_COUNT(name) AOC_COUNT_N(name, 1)
@@ -0,0 +1,86 @@
+#include "list_comparison.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+static constexpr std::int64_t VALUE_BEGIN = std::numeric_limits<int>::min();
+static constexpr std::int64_t VALUE_END =
+    std::int64_t{std::numeric_limits<int>::max()} + 1;
+
+IncrementalListComparison::IncrementalListComparison() : nodes(1) {}
+
+void IncrementalListComparison::append(const int left, const int right) {
+  left_counts[left]++;
+  if (const auto n_right = right_counts.find(left)) {
+    current.similarity_score += std::int64_t{left} * *n_right;
+  }
+  right_counts[right]++;
+  if (const auto n_left = left_counts.find(right)) {
+    current.similarity_score += std::int64_t{right} * *n_left;
+  }
+
+  if (left < right) {
+    current.distance_sum +=
+        add_difference(0, VALUE_BEGIN, VALUE_END, left, right, 1);
+  } else if (right < left) {
+    current.distance_sum +=
+        add_difference(0, VALUE_BEGIN, VALUE_END, right, left, -1);
+  }
+  n_appended++;
+}
+
+// Adds delta to D over [range_begin, range_end) within the node covering
+// [begin, end), returning the change in the sum of |D| there.
+std::int64_t IncrementalListComparison::add_difference(
+    const std::uint32_t node_index, const std::int64_t begin,
+    const std::int64_t end, const std::int64_t range_begin,
+    const std::int64_t range_end, const int delta) {
+  if (range_end <= begin || end <= range_begin) {
+    return 0;
+  }
+  if (range_begin <= begin && end <= range_end) {
+    auto& node = nodes[node_index];
+    // |D| grows where D is 0 or has the sign of delta, and shrinks elsewhere
+    const auto grows =
+        delta > 0 ? node.min_difference >= 0 : node.max_difference <= 0;
+    const auto shrinks =
+        delta > 0 ? node.max_difference < 0 : node.min_difference > 0;
+    if (grows || shrinks) {
+      node.min_difference += delta;
+      node.max_difference += delta;
+      node.pending_difference += delta;
+      return (grows ? 1 : -1) * (end - begin);
+    }
+  }
+  split(node_index);
+  const auto children = nodes[node_index].children;
+  const auto middle = begin + (end - begin) / 2;
+  const auto change =
+      add_difference(children, begin, middle, range_begin, range_end, delta) +
+      add_difference(children + 1, middle, end, range_begin, range_end, delta);
+  auto& node = nodes[node_index];
+  node.min_difference = std::min(nodes[children].min_difference,
+                                 nodes[children + 1].min_difference);
+  node.max_difference = std::max(nodes[children].max_difference,
+                                 nodes[children + 1].max_difference);
+  return change;
+}
+
+// gives the node children if it has none, and hands its pending delta down
+void IncrementalListComparison::split(const std::uint32_t node_index) {
+  if (nodes[node_index].children == 0) {
+    const auto difference = nodes[node_index].min_difference;
+    nodes[node_index].children = static_cast<std::uint32_t>(nodes.size());
+    nodes.resize(nodes.size() + 2, {difference, difference, 0, 0});
+  } else if (const auto pending = nodes[node_index].pending_difference) {
+    for (const auto child_index :
+         {nodes[node_index].children, nodes[node_index].children + 1}) {
+      auto& child = nodes[child_index];
+      child.min_difference += pending;
+      child.max_difference += pending;
+      child.pending_difference += pending;
+    }
+  }
+  nodes[node_index].pending_difference = 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "shared.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Answers of day 1 for a left and a right list of location IDs: the sum of
+// the distances between the lists sorted, and the sum of each left value times
+// the number of times it appears in the right list.
+struct ListComparison {
+  std::int64_t distance_sum = 0;
+  std::int64_t similarity_score = 0;
+};
+
+// Keeps a ListComparison current as pairs are appended to the lists, without
+// sorting the history again.
+//
+// The similarity score follows from the count of each value in either list.
+// The distance sum of two sorted lists of equal size is the sum over all
+// integers t of |D(t)|, where D(t) is the number of left values <= t minus the
+// number of right values <= t. Appending a pair (l, r) adds 1 to D over
+// [l, r), or subtracts 1 over [r, l), so it changes the distance sum by the
+// number of t in that range where |D(t)| grows minus the number where it
+// shrinks. D is kept in a segment tree over all int values with the minimum
+// and maximum of D per node, so a node where D has one sign is updated whole.
+// An append costs O(log V) plus O(log V) for each sign change of D inside the
+// range.
+class IncrementalListComparison {
+ public:
+  IncrementalListComparison();
+
+  void append(int left, int right);
+
+  const ListComparison& comparison() const { return current; }
+  std::size_t n_pairs() const { return n_appended; }
+
+ private:
+  // D over a range of values; a node without children has D uniform
+  struct Node {
+    std::int32_t min_difference = 0;
+    std::int32_t max_difference = 0;
+    std::int32_t pending_difference = 0;
+    std::uint32_t children = 0;
+  };
+
+  std::int64_t add_difference(std::uint32_t node_index, std::int64_t begin,
+                              std::int64_t end, std::int64_t range_begin,
+                              std::int64_t range_end, int delta);
+  void split(std::uint32_t node_index);
+
+  std::vector<Node> nodes;
+  FlatHashMap<int, std::int64_t> left_counts;
+  FlatHashMap<int, std::int64_t> right_counts;
+  ListComparison current;
+  std::size_t n_appended = 0;
+};
@@ -0,0 +1,17 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+
+static std::size_t& configured_worker_count() {
+  static std::size_t n_workers =
+      std::max(1u, std::thread::hardware_concurrency());
+  return n_workers;
+}
+
+std::size_t worker_count() { return configured_worker_count(); }
+
+void set_worker_count(const std::size_t n_workers) {
+  configured_worker_count() = std::max(n_workers, std::size_t{1});
+}
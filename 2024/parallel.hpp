@@ -0,0 +1,46 @@
+#pragma once
+
+#include "shared.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Number of threads parallel_for spreads work over. Defaults to the number of
+// hardware threads; 1 runs everything on the calling thread.
+std::size_t worker_count();
+void set_worker_count(std::size_t n_workers);
+
+// Splits [0, n_items) into at most worker_count() contiguous chunks and calls
+// body(item_begin, item_end) once per chunk, each on its own thread. The
+// calling thread takes the first chunk and returns once all chunks are done.
+// Chunks run concurrently, so body must synchronize any shared results, for
+// example by accumulating locally and adding to an atomic once per chunk.
+template <typename Body>
+void parallel_for(const std::size_t n_items, const Body& body) {
+  const auto n_chunks = std::min(worker_count(), n_items);
+  if (n_chunks <= 1) {
+    body(std::size_t{0}, n_items);
+    return;
+  }
+  const auto chunk_begin = [&](const std::size_t chunk_index) {
+    return n_items * chunk_index / n_chunks;
+  };
+  std::vector<std::jthread> threads;
+  threads.reserve(n_chunks - 1);
+  for (auto chunk_index = 1uz; chunk_index < n_chunks; chunk_index++) {
+    threads.emplace_back(body, chunk_begin(chunk_index),
+                         chunk_begin(chunk_index + 1));
+  }
+  body(chunk_begin(0), chunk_begin(1));
+}
+
+// parallel_for over the rows of matrix, calling body(y_begin, y_end)
+template <typename T, typename Layout, typename Body>
+void parallel_for_rows(const Matrix<T, Layout>& matrix, const Body& body) {
+  parallel_for(static_cast<std::size_t>(matrix.size().y),
+               [&](const std::size_t y_begin, const std::size_t y_end) {
+                 body(static_cast<int>(y_begin), static_cast<int>(y_end));
+               });
+}
@@ -0,0 +1,119 @@
+#include "renderer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+
+// Unchanged cells between two changed ones are rewritten rather than
+// skipped when that is shorter than a cursor position escape.
+static constexpr auto MAX_REWRITTEN_GAP = 6;
+
+Renderer::Renderer(std::ostream& ostream, const Vector2i& size,
+                   const std::optional<double> max_fps)
+    : ostream{ostream},
+      screen{size, ' '},
+      frame{size, ' '},
+      is_row_dirty(static_cast<std::size_t>(size.y), true) {
+  if (max_fps && *max_fps > 0) {
+    min_frame_time =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>{1 / *max_fps});
+  }
+}
+
+Renderer::~Renderer() {
+  if (is_screen_valid) {
+    append_cursor_move({0, size().y});
+    ostream << output << std::flush;
+  }
+}
+
+void Renderer::set(const Vector2i& location, const char c) {
+  frame.location(location) = c;
+  is_row_dirty[static_cast<std::size_t>(location.y)] = true;
+}
+
+void Renderer::fill(const char c) {
+  for (auto y = 0; y < size().y; y++) {
+    std::ranges::fill(frame.row(y), c);
+  }
+  std::fill(is_row_dirty.begin(), is_row_dirty.end(), true);
+}
+
+void Renderer::draw(const Grid& grid) {
+  const auto draw_size = Vector2i{std::min(grid.size().x, size().x),
+                                  std::min(grid.size().y, size().y)};
+  for (auto y = 0; y < draw_size.y; y++) {
+    auto x = 0;
+    for (const auto c : grid.row(y)) {
+      if (x == draw_size.x) {
+        break;
+      }
+      frame.row(y)[static_cast<std::size_t>(x++)] = c;
+    }
+    is_row_dirty[static_cast<std::size_t>(y)] = true;
+  }
+}
+
+void Renderer::append_cursor_move(const Vector2i& location) {
+  output += "\033[" + std::to_string(location.y + 1) + ";" +
+            std::to_string(location.x + 1) + "H";
+}
+
+void Renderer::present() {
+  output.clear();
+  if (!is_screen_valid) {
+    output += "\033[2J";
+    std::fill(is_row_dirty.begin(), is_row_dirty.end(), true);
+  }
+  for (auto y = 0; y < size().y; y++) {
+    if (!is_row_dirty[static_cast<std::size_t>(y)]) {
+      continue;
+    }
+    is_row_dirty[static_cast<std::size_t>(y)] = false;
+    const auto frame_row = frame.row(y);
+    const auto screen_row = screen.row(y);
+    const auto width = static_cast<int>(frame_row.size());
+    const auto is_changed = [&](const int x) {
+      const auto index = static_cast<std::size_t>(x);
+      return !is_screen_valid || frame_row[index] != screen_row[index];
+    };
+    auto x = 0;
+    while (x < width) {
+      if (!is_changed(x)) {
+        x++;
+        continue;
+      }
+      // a run of changed cells, extended over short unchanged gaps
+      const auto run_begin = x;
+      auto run_end = x + 1;
+      for (auto gap = 0; x + 1 < width && gap <= MAX_REWRITTEN_GAP;) {
+        x++;
+        if (is_changed(x)) {
+          run_end = x + 1;
+          gap = 0;
+        } else {
+          gap++;
+        }
+      }
+      x = run_end;
+      append_cursor_move({run_begin, y});
+      output.append(frame_row.begin() + run_begin,
+                    frame_row.begin() + run_end);
+    }
+    std::ranges::copy(frame_row, screen_row.begin());
+  }
+  is_screen_valid = true;
+
+  if (min_frame_time) {
+    std::this_thread::sleep_until(last_present_time + *min_frame_time);
+  }
+  ostream.write(output.data(), static_cast<std::streamsize>(output.size()));
+  ostream.flush();
+  output.clear();
+  last_present_time = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "shared.hpp"
+
+#include <chrono>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Animates frames of characters on a VT100-compatible terminal. Each frame is
+// drawn into a back buffer; present() compares it with the frame on screen
+// and writes only the changed cells, each run preceded by a cursor position
+// escape, in a single write. With max_fps set, present() also waits so that
+// frames are at least 1 / max_fps seconds apart.
+class Renderer {
+ public:
+  using Frame = Matrix<char, RowMajorLayout>;
+
+  Renderer(std::ostream& ostream, const Vector2i& size,
+           std::optional<double> max_fps = {});
+  Renderer(const Renderer&) = delete;
+  Renderer& operator=(const Renderer&) = delete;
+  // leaves the cursor below the last frame
+  ~Renderer();
+
+  Vector2i size() const { return frame.size(); }
+
+  // the frame being drawn starts as a copy of the frame on screen
+  void set(const Vector2i& location, char c);
+  void fill(char c);
+  void draw(const Grid& grid);
+
+  void present();
+
+ private:
+  void append_cursor_move(const Vector2i& location);
+
+  std::ostream& ostream;
+  Frame screen;
+  Frame frame;
+  std::vector<bool> is_row_dirty;
+  bool is_screen_valid = false;
+  std::string output;
+  std::optional<std::chrono::steady_clock::duration> min_frame_time;
+  std::chrono::steady_clock::time_point last_present_time;
+};
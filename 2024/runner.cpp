@@ -0,0 +1,214 @@
+// Runs any subset of days on given input files, repeating each solve and
+// reporting parse, part 1 and part 2 wall times. --threads sets the number of
+// threads parallel solvers use. --variants also runs each day's alternative
+// solvers on the same input. --replay then draws each day's replay, if it
+// has one, to stderr. Built with AOC_INSTRUMENTATION, each day also reports
+// its counters and timers, and --trace writes a Chrome trace file.
+//
+// usage: aoc_2024 [--repeat N] [--threads N] [--variants] [--replay]
+//                 [--trace FILE] DAY:INPUT_FILE...
+
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "solver.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct Job {
+  int day;
+  std::string input_path;
+};
+
+struct Options {
+  std::size_t n_repeats = 1;
+  std::optional<std::size_t> n_threads;
+  std::optional<std::string> trace_path;
+  bool is_running_variants = false;
+  bool is_replaying = false;
+  std::vector<Job> jobs;
+};
+
+static std::optional<int> parse_int(const std::string_view string) {
+  int value;
+  const auto [end, error] =
+      std::from_chars(string.data(), string.data() + string.size(), value);
+  if (error != std::errc{} || end != string.data() + string.size()) {
+    return {};
+  }
+  return value;
+}
+
+static std::optional<Options> parse_options(const int argc,
+                                            const char* const argv[]) {
+  Options options;
+  for (auto arg_index = 1; arg_index < argc; arg_index++) {
+    const std::string_view arg = argv[arg_index];
+    if (arg == "--repeat" && arg_index + 1 < argc) {
+      const auto n_repeats = parse_int(argv[++arg_index]);
+      if (!n_repeats || *n_repeats < 1) {
+        return {};
+      }
+      options.n_repeats = static_cast<std::size_t>(*n_repeats);
+      continue;
+    }
+    if (arg == "--threads" && arg_index + 1 < argc) {
+      const auto n_threads = parse_int(argv[++arg_index]);
+      if (!n_threads || *n_threads < 1) {
+        return {};
+      }
+      options.n_threads = static_cast<std::size_t>(*n_threads);
+      continue;
+    }
+    if (arg == "--variants") {
+      options.is_running_variants = true;
+      continue;
+    }
+    if (arg == "--replay") {
+      options.is_replaying = true;
+      continue;
+    }
+    if (arg == "--trace" && arg_index + 1 < argc) {
+      options.trace_path = argv[++arg_index];
+      continue;
+    }
+    const auto separator = arg.find(':');
+    if (separator == std::string_view::npos) {
+      return {};
+    }
+    const auto day = parse_int(arg.substr(0, separator));
+    if (!day) {
+      return {};
+    }
+    options.jobs.push_back({*day, std::string{arg.substr(separator + 1)}});
+  }
+  if (options.jobs.empty()) {
+    return {};
+  }
+  return options;
+}
+
+static std::optional<std::string> read_file(const std::string& path) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file) {
+    return {};
+  }
+  std::ostringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+static void print_times(const std::string_view name,
+                        std::vector<std::chrono::nanoseconds> times) {
+  std::ranges::sort(times);
+  const auto percentile = [&](const double p) {
+    const auto rank = static_cast<std::size_t>(
+        std::ceil(p * static_cast<double>(times.size())));
+    return times[std::max(rank, std::size_t{1}) - 1];
+  };
+  const auto to_ms = [](const std::chrono::nanoseconds time) {
+    return std::chrono::duration<double, std::milli>(time).count();
+  };
+  std::cout << "  " << std::left << std::setw(7) << name << std::right
+            << std::fixed << std::setprecision(3) << " min "
+            << std::setw(10) << to_ms(times.front()) << " ms  median "
+            << std::setw(10) << to_ms(percentile(0.5)) << " ms  p99 "
+            << std::setw(10) << to_ms(percentile(0.99)) << " ms\n";
+}
+
+static void run_solver(const std::string_view name, const Solver& solver,
+                       const std::string& input, const std::size_t n_repeats) {
+  std::vector<std::chrono::nanoseconds> parse_times;
+  std::vector<std::chrono::nanoseconds> part_1_times;
+  std::vector<std::chrono::nanoseconds> part_2_times;
+  Solution solution;
+  for (auto repeat = 0uz; repeat < n_repeats; repeat++) {
+    std::istringstream istream{input};
+    solution = solver(istream);
+    parse_times.push_back(solution.parse_time);
+    part_1_times.push_back(solution.part_1_time);
+    part_2_times.push_back(solution.part_2_time);
+  }
+
+  std::cout << name << "\n";
+  std::cout << "  part 1: " << solution.part_1 << "\n";
+  std::cout << "  part 2: " << solution.part_2 << "\n";
+  print_times("parse", parse_times);
+  print_times("part 1", part_1_times);
+  print_times("part 2", part_2_times);
+  if constexpr (IS_INSTRUMENTATION_ENABLED) {
+    print_instrumentation_report(std::cout);
+    reset_instrumentation_report();
+  }
+}
+
+static bool run_job(const Job& job, const Options& options) {
+  const auto solver_it = solvers().find(job.day);
+  if (solver_it == solvers().cend()) {
+    std::cerr << "no solver for day " << job.day << "\n";
+    return false;
+  }
+  const auto input = read_file(job.input_path);
+  if (!input) {
+    std::cerr << "cannot read " << job.input_path << "\n";
+    return false;
+  }
+
+  const auto job_name = "day " + std::to_string(job.day) + " (" +
+                        job.input_path + ", " +
+                        std::to_string(options.n_repeats) + " runs)";
+  run_solver(job_name, solver_it->second, *input, options.n_repeats);
+  const auto variants_it = solver_variants().find(job.day);
+  if (options.is_running_variants && variants_it != solver_variants().cend()) {
+    for (const auto& [variant_name, variant_solver] : variants_it->second) {
+      run_solver(job_name + " variant " + variant_name, variant_solver,
+                 *input, options.n_repeats);
+    }
+  }
+  const auto replay_it = replays().find(job.day);
+  if (options.is_replaying && replay_it != replays().cend()) {
+    std::istringstream istream{*input};
+    replay_it->second(istream, std::clog);
+  }
+  return true;
+}
+
+int main(const int argc, const char* const argv[]) {
+  const auto options = parse_options(argc, argv);
+  if (!options) {
+    std::cerr << "usage: " << argv[0]
+              << " [--repeat N] [--threads N] [--variants] [--replay] "
+                 "[--trace FILE] DAY:INPUT_FILE...\n";
+    return 1;
+  }
+  if (options->n_threads) {
+    set_worker_count(*options->n_threads);
+  }
+  auto is_success = true;
+  for (const auto& job : options->jobs) {
+    is_success = run_job(job, *options) && is_success;
+  }
+  if (options->trace_path) {
+    if (!IS_INSTRUMENTATION_ENABLED) {
+      std::cerr << "built without AOC_INSTRUMENTATION, the trace is empty\n";
+    }
+    std::ofstream trace_file{*options->trace_path};
+    write_chrome_trace(trace_file);
+    if (!trace_file) {
+      std::cerr << "cannot write " << *options->trace_path << "\n";
+      is_success = false;
+    }
+  }
+  return is_success ? 0 : 1;
+}
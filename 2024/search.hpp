@@ -0,0 +1,232 @@
+#pragma once
+
+#include "instrumentation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+enum class SearchMode { BREADTH_FIRST, DIJKSTRA, A_STAR };
+
+// Priority queue for integer keys that never drop below the last popped key,
+// as in Dijkstra's algorithm. Entries are bucketed by the highest bit in which
+// their key differs from the last popped key, and a pop only redistributes the
+// lowest non-empty bucket, so mixes of small and large costs (like 1 and 1000)
+// cost amortized O(log C) per entry for maximum cost C.
+template <typename Value>
+class RadixHeap {
+ public:
+  bool empty() const { return n_entries == 0; }
+
+  void push(const std::uint64_t key, const Value& value) {
+    assert(key >= last_key);
+    buckets[bucket_index(key)].emplace_back(key, value);
+    n_entries++;
+  }
+
+  std::pair<std::uint64_t, Value> pop() {
+    assert(!empty());
+    if (buckets[0].empty()) {
+      auto bucket_it = std::ranges::find_if(
+          buckets, [](const auto& bucket) { return !bucket.empty(); });
+      last_key = std::ranges::min(*bucket_it, {}, &Entry::first).first;
+      for (const auto& entry : *bucket_it) {
+        buckets[bucket_index(entry.first)].push_back(entry);
+      }
+      bucket_it->clear();
+    }
+    const auto entry = buckets[0].back();
+    buckets[0].pop_back();
+    n_entries--;
+    return entry;
+  }
+
+  void clear() {
+    for (auto& bucket : buckets) {
+      bucket.clear();
+    }
+    last_key = 0;
+    n_entries = 0;
+  }
+
+ private:
+  using Entry = std::pair<std::uint64_t, Value>;
+
+  std::size_t bucket_index(const std::uint64_t key) const {
+    return static_cast<std::size_t>(std::bit_width(key ^ last_key));
+  }
+
+  std::array<std::vector<Entry>, 65> buckets;
+  std::uint64_t last_key = 0;
+  std::size_t n_entries = 0;
+};
+
+struct SearchCounters {
+  std::size_t n_expanded = 0;  // states whose neighbours were generated
+  std::size_t n_queued = 0;    // states queued with a new shortest distance
+};
+
+// Shortest path search over states that map to dense indices [0, n_states),
+// for example Matrix::index of a location. Distances are kept in a flat array
+// indexed by state index, and so are predecessors when KEEP_PREDECESSORS is
+// set for path(). Only the states a run reaches are reset before the next
+// run, so many small searches over a large state space stay cheap.
+//
+// neighbours(state, visit) calls visit(neighbour) for every state reachable
+// in one step. step_cost(state, neighbour) is the non-negative cost of that
+// step; breadth-first search ignores it and counts steps. heuristic(state) is
+// a consistent lower bound on the remaining cost, used by A* only.
+template <typename State, typename StateIndex, bool KEEP_PREDECESSORS = false>
+class Search {
+ public:
+  using Cost = std::int64_t;
+  static constexpr auto UNREACHED = std::numeric_limits<Cost>::max();
+
+  struct UnitCost {
+    Cost operator()(const State&, const State&) const { return 1; }
+  };
+  struct NoGoal {
+    bool operator()(const State&) const { return false; }
+  };
+  struct NoHeuristic {
+    Cost operator()(const State&) const { return 0; }
+  };
+
+  Search(const std::size_t n_states, StateIndex state_index)
+      : state_index{state_index},
+        distances(n_states, UNREACHED),
+        predecessors(KEEP_PREDECESSORS ? n_states : 0) {}
+
+  // Searches from starts until a goal is expanded, returning it, or until
+  // every reachable state is expanded, returning nothing.
+  template <typename Neighbours, typename StepCost = UnitCost,
+            typename IsGoal = NoGoal, typename Heuristic = NoHeuristic>
+  std::optional<State> run(const SearchMode mode,
+                           const std::span<const State> starts,
+                           Neighbours neighbours, StepCost step_cost = {},
+                           IsGoal is_goal = {}, Heuristic heuristic = {}) {
+    reset();
+    for (const auto& start : starts) {
+      const auto start_index = state_index(start);
+      if (distances[start_index] == UNREACHED) {
+        reached_states.push_back(start);
+      }
+      distances[start_index] = 0;
+      set_predecessor(start_index, start);
+    }
+
+    if (mode == SearchMode::BREADTH_FIRST) {
+      // states are reached in breadth-first order, so they are the queue
+      for (auto queue_index = 0uz; queue_index < reached_states.size();
+           queue_index++) {
+        const auto state = reached_states[queue_index];
+        search_counters.n_expanded++;
+        AOC_COUNT("search expanded");
+        if (is_goal(state)) {
+          return state;
+        }
+        const auto next_distance = distances[state_index(state)] + 1;
+        neighbours(state, [&](const State& next) {
+          const auto next_index = state_index(next);
+          if (distances[next_index] == UNREACHED) {
+            distances[next_index] = next_distance;
+            set_predecessor(next_index, state);
+            reached_states.push_back(next);
+            search_counters.n_queued++;
+          }
+        });
+      }
+      return {};
+    }
+
+    const auto key = [&](const State& state, const Cost distance) {
+      const auto remaining =
+          mode == SearchMode::A_STAR ? heuristic(state) : Cost{0};
+      return static_cast<std::uint64_t>(distance + remaining);
+    };
+    queue.clear();
+    for (const auto& start : starts) {
+      queue.push(key(start, 0), start);
+    }
+    while (!queue.empty()) {
+      const auto [state_key, state] = queue.pop();
+      const auto distance = distances[state_index(state)];
+      if (state_key != key(state, distance)) {
+        // superseded by a shorter distance queued later
+        continue;
+      }
+      search_counters.n_expanded++;
+      AOC_COUNT("search expanded");
+      if (is_goal(state)) {
+        return state;
+      }
+      neighbours(state, [&](const State& next) {
+        const auto next_index = state_index(next);
+        const auto next_distance = distance + step_cost(state, next);
+        if (next_distance < distances[next_index]) {
+          if (distances[next_index] == UNREACHED) {
+            reached_states.push_back(next);
+          }
+          distances[next_index] = next_distance;
+          set_predecessor(next_index, state);
+          queue.push(key(next, next_distance), next);
+          search_counters.n_queued++;
+        }
+      });
+    }
+    return {};
+  }
+
+  // distance from the nearest start of the last run, or UNREACHED
+  Cost distance(const State& state) const {
+    return distances[state_index(state)];
+  }
+
+  // states from a start to state along predecessors of the last run
+  std::vector<State> path(const State& state) const
+    requires KEEP_PREDECESSORS
+  {
+    assert(distance(state) != UNREACHED);
+    std::vector<State> states{state};
+    while (predecessors[state_index(states.back())] != states.back()) {
+      states.push_back(predecessors[state_index(states.back())]);
+    }
+    std::ranges::reverse(states);
+    return states;
+  }
+
+  // states reached by the last run, in the order they were first reached
+  std::span<const State> reached() const { return reached_states; }
+
+  // totals over all runs
+  const SearchCounters& counters() const { return search_counters; }
+
+ private:
+  void reset() {
+    for (const auto& state : reached_states) {
+      distances[state_index(state)] = UNREACHED;
+    }
+    reached_states.clear();
+  }
+
+  void set_predecessor(const std::size_t index, const State& predecessor) {
+    if constexpr (KEEP_PREDECESSORS) {
+      predecessors[index] = predecessor;
+    }
+  }
+
+  StateIndex state_index;
+  std::vector<Cost> distances;
+  std::vector<State> predecessors;
+  std::vector<State> reached_states;
+  RadixHeap<State> queue;
+  SearchCounters search_counters;
+};
@@ -1,33 +1,218 @@
 #include "shared.hpp"
 
-#include <cctype>
-#include <ios>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
-#include <ranges>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <vector>
 
-std::vector<int> extract_values(std::istream& istream) {
-  istream >> std::noskipws;
-  const auto stripped_input = std::views::istream<char>(istream) |
-                              std::views::transform([](char c) {
-                                return std::isdigit(c) || c == '-' ? c : ' ';
-                              }) |
-                              std::ranges::to<std::string>();
-  auto stripped_input_ss = std::istringstream{stripped_input};
-  return std::views::istream<int>(stripped_input_ss) |
-         std::ranges::to<std::vector<int>>();
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+static bool is_digit(const char c) { return c >= '0' && c <= '9'; }
+
+// Digit masks use signed byte compares: bytes >= 0x80 are negative and so
+// never fall inside ['0', '9'].
+
+#if defined(__AVX2__)
+static __m256i is_digit_mask(const __m256i block) {
+  return _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('0' - 1)),
+                          _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), block));
+}
+#endif
+
+#if defined(__SSE2__)
+static __m128i is_digit_mask(const __m128i block) {
+  return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('0' - 1)),
+                       _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), block));
+}
+#endif
+
+const char* find_value_char(const char* begin, const char* end) {
+  auto it = begin;
+#if defined(__AVX2__)
+  for (; end - it >= 32; it += 32) {
+    const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+    const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(is_digit_mask(block),
+                        _mm256_cmpeq_epi8(block, _mm256_set1_epi8('-')))));
+    if (mask != 0) {
+      return it + std::countr_zero(mask);
+    }
+  }
+#endif
+#if defined(__SSE2__)
+  for (; end - it >= 16; it += 16) {
+    const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+    const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+        _mm_or_si128(is_digit_mask(block),
+                     _mm_cmpeq_epi8(block, _mm_set1_epi8('-')))));
+    if (mask != 0) {
+      return it + std::countr_zero(mask);
+    }
+  }
+#endif
+  for (; it != end; ++it) {
+    if (is_digit(*it) || *it == '-') {
+      return it;
+    }
+  }
+  return end;
+}
+
+const char* find_non_digit(const char* begin, const char* end) {
+  auto it = begin;
+#if defined(__AVX2__)
+  for (; end - it >= 32; it += 32) {
+    const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+    const auto mask = ~static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(is_digit_mask(block)));
+    if (mask != 0) {
+      return it + std::countr_zero(mask);
+    }
+  }
+#endif
+#if defined(__SSE2__)
+  for (; end - it >= 16; it += 16) {
+    const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+    const auto mask =
+        ~static_cast<std::uint32_t>(_mm_movemask_epi8(is_digit_mask(block))) &
+        0xffff;
+    if (mask != 0) {
+      return it + std::countr_zero(mask);
+    }
+  }
+#endif
+  for (; it != end; ++it) {
+    if (!is_digit(*it)) {
+      return it;
+    }
+  }
+  return end;
+}
+
+Grid extract_grid(std::istream& istream) { return Grid{istream}; }
+
+Vector2i extract_size_line(std::istream& istream,
+                           const Vector2i& default_size) {
+  if (istream.peek() != 's') {
+    return default_size;
+  }
+  std::string line;
+  std::getline(istream, line);
+  std::istringstream line_stream{line};
+  const auto values = extract_values(line_stream);
+  assert(values.size() == 2);
+  return {values[0], values[1]};
 }
 
-void print_grid(const Grid& grid, std::vector<Vector2i>& locations) {
-  auto new_grid = grid;
-  for (const auto& location : locations) {
-    new_grid.location(location) = 'x';
+static void extend_bounds(BitGridBounds& bounds, const int y,
+                          const std::size_t word_index) {
+  if (bounds.empty()) {
+    bounds = {y, y + 1, word_index, word_index + 1};
+    return;
+  }
+  bounds.y_begin = std::min(bounds.y_begin, y);
+  bounds.y_end = std::max(bounds.y_end, y + 1);
+  bounds.word_begin = std::min(bounds.word_begin, word_index);
+  bounds.word_end = std::max(bounds.word_end, word_index + 1);
+}
+
+std::optional<int> BitGridSearch::find_distance(const BitGrid& mask,
+                                                const Vector2i& start,
+                                                const Vector2i& goal) {
+  return search(mask, start, goal);
+}
+
+void BitGridSearch::flood_fill(const BitGrid& mask, const Vector2i& start) {
+  search(mask, start, {});
+}
+
+std::optional<int> BitGridSearch::search(const BitGrid& mask,
+                                         const Vector2i& start,
+                                         const std::optional<Vector2i>& goal) {
+  assert(mask.size() == visited_grid.size());
+  for (const auto& [y, word_index] : visited_words) {
+    visited_grid.row(y)[word_index] = 0;
+  }
+  for (const auto& [y, word_index] : frontier_words) {
+    frontier.row(y)[word_index] = 0;
+  }
+  visited_words.clear();
+  frontier_words.clear();
+  visited_box = {};
+  if (!mask.location(start)) {
+    return {};
+  }
+
+  const auto start_word_index =
+      static_cast<std::size_t>(start.x / BitGrid::WORD_BITS);
+  visited_grid.set(start);
+  frontier.set(start);
+  visited_words.push_back({start.y, start_word_index});
+  frontier_words.push_back({start.y, start_word_index});
+  extend_bounds(visited_box, start.y, start_word_index);
+
+  for (auto distance = 0;; distance++) {
+    if (goal && frontier.location(*goal)) {
+      return distance;
+    }
+
+    // neighbours of a frontier word lie in it, the words beside it or the
+    // words above and below it; words reached twice find nothing new the
+    // second time, so next_frontier_words holds no duplicates
+    for (const auto& [y, word_index] : frontier_words) {
+      if (word_index > 0) {
+        visit(mask, y, word_index - 1);
+      }
+      visit(mask, y, word_index);
+      if (word_index + 1 < mask.row_words()) {
+        visit(mask, y, word_index + 1);
+      }
+      if (y > 0) {
+        visit(mask, y - 1, word_index);
+      }
+      if (y + 1 < mask.size().y) {
+        visit(mask, y + 1, word_index);
+      }
+    }
+    for (const auto& [y, word_index] : frontier_words) {
+      frontier.row(y)[word_index] = 0;
+    }
+    frontier_words.clear();
+    if (next_frontier_words.empty()) {
+      return {};
+    }
+    std::swap(frontier, next_frontier);
+    std::swap(frontier_words, next_frontier_words);
+  }
+}
+
+void BitGridSearch::visit(const BitGrid& mask, const int y,
+                          const std::size_t word_index) {
+  const auto neighbours =
+      frontier.word(y, word_index, -1) | frontier.word(y, word_index, 1) |
+      frontier.word(y - 1, word_index) | frontier.word(y + 1, word_index);
+  auto& visited_word = visited_grid.row(y)[word_index];
+  const auto bits = neighbours & mask.row(y)[word_index] & ~visited_word;
+  if (bits == 0) {
+    return;
+  }
+  if (visited_word == 0) {
+    visited_words.push_back({y, word_index});
+    extend_bounds(visited_box, y, word_index);
+  }
+  visited_word |= bits;
+  auto& next_word = next_frontier.row(y)[word_index];
+  if (next_word == 0) {
+    next_frontier_words.push_back({y, word_index});
   }
-  std::cout << "\033c";
-  std::cout << "\033[H";
-  std::cout << new_grid << "\n";
+  next_word |= bits;
 }
 
 Vector2i operator*(const int lhs, const Vector2i& rhs) {
@@ -39,8 +224,9 @@ std::ostream& operator<<(std::ostream& ostream, const Vector2i& v) {
 }
 
 std::ostream& operator<<(std::ostream& ostream, const Matrix<char>& matrix) {
-  for (const auto& v : matrix.locations) {
-    ostream << std::string{v.begin(), v.end()} << "\n";
+  for (auto y = 0; y < matrix.size().y; y++) {
+    const auto row = matrix.row(y);
+    ostream << std::string{row.begin(), row.end()} << "\n";
   }
   return ostream;
 }
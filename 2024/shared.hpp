@@ -1,12 +1,153 @@
+#pragma once
+
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <generator>
 #include <iostream>
 #include <istream>
 #include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-std::vector<int> extract_values(std::istream& istream);
+// first digit or '-' in [begin, end), or end if none (SIMD when available)
+const char* find_value_char(const char* begin, const char* end);
+
+// first non-digit in [begin, end), or end if none (SIMD when available)
+const char* find_non_digit(const char* begin, const char* end);
+
+// Single-pass scanner for (optionally negative) integers embedded in
+// arbitrary text. Text may be fed in blocks of any size; a value cut off at
+// the end of one block is completed by the next.
+template <std::integral T>
+class ValueScanner {
+ public:
+  template <typename Emit>
+  void scan(const std::string_view text, Emit&& emit) {
+    auto it = text.data();
+    const auto end = it + text.size();
+    while (it != end) {
+      if (!is_in_value) {
+        if (!is_negative) {
+          it = find_value_char(it, end);
+          if (it == end) {
+            break;
+          }
+        }
+        if (*it == '-') {
+          is_negative = true;
+          ++it;
+          continue;
+        }
+        if (*it < '0' || *it > '9') {
+          // '-' not followed by a digit
+          is_negative = false;
+          continue;
+        }
+        is_in_value = true;
+      }
+      const auto digits_end = find_non_digit(it, end);
+      for (; it != digits_end; ++it) {
+        value = static_cast<T>(value * 10 + static_cast<T>(*it - '0'));
+      }
+      if (it == end) {
+        // value may continue in next block
+        break;
+      }
+      emit(take_value());
+    }
+  }
+
+  template <typename Emit>
+  void finish(Emit&& emit) {
+    if (is_in_value) {
+      emit(take_value());
+    }
+    is_negative = false;
+  }
+
+ private:
+  T take_value() {
+    const auto signed_value = is_negative ? static_cast<T>(-value) : value;
+    value = {};
+    is_in_value = false;
+    is_negative = false;
+    return signed_value;
+  }
+
+  T value{};
+  bool is_in_value = false;
+  bool is_negative = false;
+};
+
+// calls emit(value) for every value of istream, read in 64 KiB blocks
+template <std::integral T, typename Emit>
+void scan_values(std::istream& istream, Emit&& emit) {
+  ValueScanner<T> scanner;
+  std::string buffer(1 << 16, '\0');
+  while (istream) {
+    istream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    const auto n_read = static_cast<std::size_t>(istream.gcount());
+    scanner.scan({buffer.data(), n_read}, emit);
+  }
+  scanner.finish(emit);
+}
+
+template <std::integral T = int>
+std::vector<T> extract_values(std::istream& istream) {
+  std::vector<T> values;
+  scan_values<T>(istream, [&](const T value) { values.push_back(value); });
+  return values;
+}
+
+// Values of istream as they are scanned, read one 64 KiB block at a time, so
+// memory stays constant however long the input is. Unlike extract_values the
+// values can only be consumed once, in order.
+template <std::integral T = int>
+std::generator<T> stream_values(std::istream& istream) {
+  ValueScanner<T> scanner;
+  std::vector<T> block_values;
+  const auto emit = [&](const T value) { block_values.push_back(value); };
+  std::string buffer(1 << 16, '\0');
+  while (istream) {
+    istream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    const auto n_read = static_cast<std::size_t>(istream.gcount());
+    scanner.scan({buffer.data(), n_read}, emit);
+    for (const auto value : block_values) {
+      co_yield value;
+    }
+    block_values.clear();
+  }
+  scanner.finish(emit);
+  for (const auto value : block_values) {
+    co_yield value;
+  }
+}
+
+// The first N values of range, or value-initialized ones if it is shorter.
+// Copies chunks of an input range like stream_values into something that can
+// be indexed.
+template <std::size_t N, std::ranges::input_range Range>
+std::array<std::ranges::range_value_t<Range>, N> take_array(Range&& range) {
+  std::array<std::ranges::range_value_t<Range>, N> values{};
+  auto value_it = values.begin();
+  for (auto range_it = std::ranges::begin(range);
+       range_it != std::ranges::end(range) && value_it != values.end();
+       ++range_it, ++value_it) {
+    *value_it = *range_it;
+  }
+  return values;
+}
 
 struct Line {
   std::string line_string;
@@ -52,40 +193,313 @@ Vector2i operator*(const int lhs, const Vector2i& rhs);
 
 std::ostream& operator<<(std::ostream& ostream, const Vector2i& v);
 
-template <typename T>
+// x and y packed into one 64-bit value; FlatHashTable mixes the bits
+template <>
+struct std::hash<Vector2i> {
+  std::size_t operator()(const Vector2i& v) const noexcept {
+    return (std::uint64_t{static_cast<std::uint32_t>(v.x)} << 32) |
+           static_cast<std::uint32_t>(v.y);
+  }
+};
+
+// Open-addressing hash table. Entries are stored contiguously in insertion
+// order, and the slots hold entry index + 1 (0 for an empty slot), probed
+// linearly from a Fibonacci hash of the key. Entries cannot be erased.
+template <typename Key, typename Entry, typename Hash>
+class FlatHashTable {
+ public:
+  std::size_t size() const { return entries.size(); }
+  bool empty() const { return entries.empty(); }
+
+  auto begin() const { return entries.cbegin(); }
+  auto end() const { return entries.cend(); }
+
+  bool contains(const Key& key) const { return slots[find_slot(key)] != 0; }
+
+  void reserve(const std::size_t n_entries) {
+    entries.reserve(n_entries);
+    if (is_overloaded(n_entries)) {
+      rehash(std::bit_ceil(
+          n_entries * MAX_LOAD_DENOMINATOR / MAX_LOAD_NUMERATOR + 1));
+    }
+  }
+
+  void clear() {
+    entries.clear();
+    std::ranges::fill(slots, 0);
+  }
+
+ protected:
+  FlatHashTable() : slots(MIN_SLOTS) {}
+
+  // index of the entry with key, emplacing it from args if there is none
+  template <typename... Args>
+  std::pair<std::size_t, bool> emplace_entry(const Key& key, Args&&... args) {
+    auto slot = find_slot(key);
+    if (slots[slot] != 0) {
+      return {slots[slot] - 1, false};
+    }
+    if (is_overloaded(entries.size() + 1)) {
+      rehash(slots.size() * 2);
+      slot = find_slot(key);
+    }
+    entries.emplace_back(std::forward<Args>(args)...);
+    slots[slot] = static_cast<std::uint32_t>(entries.size());
+    return {entries.size() - 1, true};
+  }
+
+  // entry with key, or nullptr if there is none
+  const Entry* find_entry(const Key& key) const {
+    const auto slot = slots[find_slot(key)];
+    return slot != 0 ? &entries[slot - 1] : nullptr;
+  }
+
+  std::vector<Entry> entries;
+
+ private:
+  static constexpr std::size_t MIN_SLOTS = 16;
+  static constexpr std::size_t MAX_LOAD_NUMERATOR = 3;
+  static constexpr std::size_t MAX_LOAD_DENOMINATOR = 4;
+
+  // slot holding key, or the empty slot where it would go
+  std::size_t find_slot(const Key& key) const {
+    const auto mask = slots.size() - 1;
+    auto slot = static_cast<std::size_t>(
+        (static_cast<std::uint64_t>(hash(key)) * 0x9e3779b97f4a7c15) >>
+        slot_shift);
+    while (slots[slot] != 0 && key_of(entries[slots[slot] - 1]) != key) {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  static const Key& key_of(const Entry& entry) {
+    if constexpr (std::same_as<Key, Entry>) {
+      return entry;
+    } else {
+      return entry.first;
+    }
+  }
+
+  bool is_overloaded(const std::size_t n_entries) const {
+    return n_entries * MAX_LOAD_DENOMINATOR > slots.size() * MAX_LOAD_NUMERATOR;
+  }
+
+  void rehash(const std::size_t n_slots) {
+    slots.assign(n_slots, 0);
+    slot_shift = 64 - std::countr_zero(n_slots);
+    for (auto entry_index = 0uz; entry_index < entries.size(); entry_index++) {
+      slots[find_slot(key_of(entries[entry_index]))] =
+          static_cast<std::uint32_t>(entry_index + 1);
+    }
+  }
+
+  std::vector<std::uint32_t> slots;
+  int slot_shift = 64 - std::countr_zero(MIN_SLOTS);
+  [[no_unique_address]] Hash hash;
+};
+
+template <typename Key, typename Hash = std::hash<Key>>
+class FlatHashSet : public FlatHashTable<Key, Key, Hash> {
+ public:
+  // whether key was not in the set before
+  bool insert(const Key& key) { return this->emplace_entry(key, key).second; }
+};
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap
+    : public FlatHashTable<Key, std::pair<Key, Value>, Hash> {
+ public:
+  Value& operator[](const Key& key) {
+    const auto entry_index = this->emplace_entry(key, key, Value{}).first;
+    return this->entries[entry_index].second;
+  }
+
+  // value of key, or nullptr if there is none
+  const Value* find(const Key& key) const {
+    const auto entry = this->find_entry(key);
+    return entry ? &entry->second : nullptr;
+  }
+};
+
+// Storage layouts for Matrix, mapping a location to the offset of its cell.
+// Locations are always indexed and iterated in row-major order; a layout only
+// decides where cells live in memory.
+
+// rows one after another
+class RowMajorLayout {
+ public:
+  static constexpr bool IS_ROW_MAJOR = true;
+
+  RowMajorLayout() = default;
+  explicit RowMajorLayout(const Vector2i& size)
+      : width{static_cast<std::size_t>(size.x)},
+        height{static_cast<std::size_t>(size.y)} {}
+
+  std::size_t n_cells() const { return width * height; }
+
+  std::size_t offset(const Vector2i& location) const {
+    return static_cast<std::size_t>(location.y) * width +
+           static_cast<std::size_t>(location.x);
+  }
+
+ private:
+  std::size_t width = 0;
+  std::size_t height = 0;
+};
+
+// TILE_SIZE x TILE_SIZE tiles stored row-major, tiles in row-major order, so
+// vertical neighbours are usually in the same tile. Edge tiles are padded.
+template <std::size_t TILE_SIZE>
+  requires(std::has_single_bit(TILE_SIZE))
+class TiledLayout {
+ public:
+  static constexpr bool IS_ROW_MAJOR = false;
+
+  TiledLayout() = default;
+  explicit TiledLayout(const Vector2i& size)
+      : n_row_tiles{n_tiles(size.x)}, n_column_tiles{n_tiles(size.y)} {}
+
+  std::size_t n_cells() const {
+    return n_row_tiles * n_column_tiles * TILE_SIZE * TILE_SIZE;
+  }
+
+  std::size_t offset(const Vector2i& location) const {
+    const auto x = static_cast<std::size_t>(location.x);
+    const auto y = static_cast<std::size_t>(location.y);
+    const auto tile_index = (y / TILE_SIZE) * n_row_tiles + x / TILE_SIZE;
+    return tile_index * TILE_SIZE * TILE_SIZE + (y % TILE_SIZE) * TILE_SIZE +
+           x % TILE_SIZE;
+  }
+
+ private:
+  static std::size_t n_tiles(const int length) {
+    return (static_cast<std::size_t>(length) + TILE_SIZE - 1) / TILE_SIZE;
+  }
+
+  std::size_t n_row_tiles = 0;
+  std::size_t n_column_tiles = 0;
+};
+
+// Z-order curve, the bits of x and y interleaved, so nearby locations in any
+// direction tend to be nearby in memory. Padded to a power-of-two square.
+class MortonLayout {
+ public:
+  static constexpr bool IS_ROW_MAJOR = false;
+
+  MortonLayout() = default;
+  explicit MortonLayout(const Vector2i& size)
+      : side{std::bit_ceil(
+            static_cast<std::uint32_t>(std::max(size.x, size.y)))} {}
+
+  std::size_t n_cells() const { return std::size_t{side} * side; }
+
+  std::size_t offset(const Vector2i& location) const {
+    return spread_bits(static_cast<std::uint32_t>(location.x)) |
+           spread_bits(static_cast<std::uint32_t>(location.y)) << 1;
+  }
+
+ private:
+  // bit i of value moved to bit 2 * i
+  static std::size_t spread_bits(const std::uint32_t value) {
+    auto bits = std::uint64_t{value};
+    bits = (bits | bits << 16) & 0x0000ffff0000ffff;
+    bits = (bits | bits << 8) & 0x00ff00ff00ff00ff;
+    bits = (bits | bits << 4) & 0x0f0f0f0f0f0f0f0f;
+    bits = (bits | bits << 2) & 0x3333333333333333;
+    bits = (bits | bits << 1) & 0x5555555555555555;
+    return static_cast<std::size_t>(bits);
+  }
+
+  std::uint32_t side = 0;
+};
+
+// layout of Matrix unless given, chosen at build time (see CMakeLists.txt)
+#if defined(AOC_MATRIX_LAYOUT_TILED)
+using DefaultLayout = TiledLayout<8>;
+#elif defined(AOC_MATRIX_LAYOUT_MORTON)
+using DefaultLayout = MortonLayout;
+#else
+using DefaultLayout = RowMajorLayout;
+#endif
+
+template <typename T, typename Layout = DefaultLayout>
 class Matrix {
  public:
+  // Random-access iterator over the elements in row-major order. It also
+  // converts to the location of the element it points to.
   class iterator {
    public:
-    using iterator_category = std::forward_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
     using value_type = T;
     using difference_type = std::ptrdiff_t;
-    using reference = Vector2i&;
+    using pointer = const T*;
+    using reference = const T&;
 
-    iterator(const Matrix* const matrix, const Vector2i& location = {})
-        : matrix{matrix}, location{location} {}
-    bool operator!=(const iterator& rhs) const {
-      return matrix != rhs.matrix || location != rhs.location;
-    }
+    iterator() = default;
+    iterator(const Matrix* const matrix, const std::size_t index)
+        : matrix{matrix}, index{index} {}
+
+    operator Vector2i() const { return matrix->location_at(index); }
 
-    operator Vector2i() const { return location; }
+    reference operator*() const { return matrix->cell_at(index); }
+    pointer operator->() const { return &**this; }
+    reference operator[](const difference_type n) const {
+      return *(*this + n);
+    }
 
     iterator& operator++() {
-      if (++location.x == matrix->size().x) {
-        location.x = 0;
-        location.y++;
-      }
+      index++;
+      return *this;
+    }
+    iterator operator++(int) {
+      auto it = *this;
+      ++*this;
+      return it;
+    }
+    iterator& operator--() {
+      index--;
       return *this;
     }
-    T operator*() const { return matrix->location(location); }
+    iterator operator--(int) {
+      auto it = *this;
+      --*this;
+      return it;
+    }
 
-   protected:
-    const Matrix* matrix;
-    Vector2i location;
+    iterator& operator+=(const difference_type n) {
+      index = static_cast<std::size_t>(static_cast<difference_type>(index) + n);
+      return *this;
+    }
+    iterator& operator-=(const difference_type n) { return *this += -n; }
+    iterator operator+(const difference_type n) const {
+      auto it = *this;
+      return it += n;
+    }
+    friend iterator operator+(const difference_type n, const iterator& it) {
+      return it + n;
+    }
+    iterator operator-(const difference_type n) const {
+      auto it = *this;
+      return it -= n;
+    }
+    difference_type operator-(const iterator& rhs) const {
+      return static_cast<difference_type>(index) -
+             static_cast<difference_type>(rhs.index);
+    }
+
+    bool operator==(const iterator& rhs) const { return index == rhs.index; }
+    auto operator<=>(const iterator& rhs) const { return index <=> rhs.index; }
+
+   private:
+    const Matrix* matrix = nullptr;
+    std::size_t index = 0;
   };
 
-  iterator cbegin() const { return iterator(this, Vector2i{}); }
-  iterator cend() const { return iterator(this, {0, size().y}); }
+  iterator cbegin() const { return iterator(this, 0); }
+  iterator cend() const { return iterator(this, n_locations()); }
+  iterator begin() const { return cbegin(); }
+  iterator end() const { return cend(); }
 
   static constexpr auto DIRECTIONS = std::to_array<Vector2i>(
       {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}});
@@ -94,35 +508,91 @@ class Matrix {
   enum CardinalDirection : int { NORTH, EAST, SOUTH, WEST, END };
 
   Matrix(std::istream& istream) {
-    std::copy(std::istream_iterator<Line>{istream}, {},
-              std::back_inserter(locations));
+    for (auto line_it = std::istream_iterator<Line>{istream};
+         line_it != std::istream_iterator<Line>{}; ++line_it) {
+      const auto& line = line_it->line_string;
+      if (matrix_size.y == 0) {
+        matrix_size.x = static_cast<int>(line.size());
+      }
+      assert(static_cast<int>(line.size()) == matrix_size.x);
+      locations.insert(locations.cend(), line.cbegin(), line.cend());
+      matrix_size.y++;
+    }
+    layout = Layout{matrix_size};
+    if constexpr (!Layout::IS_ROW_MAJOR) {
+      // lines were read row-major
+      std::vector<T> cells(layout.n_cells());
+      for (auto index = 0uz; index < locations.size(); index++) {
+        cells[layout.offset(location_at(index))] = locations[index];
+      }
+      locations = std::move(cells);
+    }
+  }
+
+  Matrix(const Vector2i& size, const T ch = {})
+      : layout{size}, locations(layout.n_cells(), ch), matrix_size{size} {}
+
+  Vector2i size() const { return matrix_size; }
+
+  std::size_t n_locations() const {
+    return static_cast<std::size_t>(matrix_size.x) *
+           static_cast<std::size_t>(matrix_size.y);
+  }
+
+  // number of locations between the indices of two consecutive rows
+  std::size_t stride() const { return static_cast<std::size_t>(matrix_size.x); }
+
+  // linear (row-major) index of location, and location of linear index
+  std::size_t index(const Vector2i& location) const {
+    return static_cast<std::size_t>(location.y) * stride() +
+           static_cast<std::size_t>(location.x);
   }
 
-  Matrix(const Vector2i& size, const T ch = {}) {
-    std::fill_n(std::back_inserter(locations), size.y,
-                std::vector(static_cast<std::size_t>(size.x), ch));
+  Vector2i location_at(const std::size_t index) const {
+    return {static_cast<int>(index % stride()),
+            static_cast<int>(index / stride())};
   }
 
-  Vector2i size() const {
-    return {static_cast<int>(locations[0].size()),
-            static_cast<int>(locations.size())};
+  // locations of row y, as a span when rows are contiguous in memory
+  auto row(const int y) const {
+    assert(y >= 0 && y < matrix_size.y);
+    if constexpr (Layout::IS_ROW_MAJOR) {
+      return std::span<const T>{locations.data() + layout.offset({0, y}),
+                                stride()};
+    } else {
+      return std::views::iota(0, matrix_size.x) |
+             std::views::transform([this, y](const int x) {
+               return locations[layout.offset({x, y})];
+             });
+    }
+  }
+
+  std::span<T> row(const int y)
+    requires Layout::IS_ROW_MAJOR
+  {
+    assert(y >= 0 && y < matrix_size.y);
+    return {locations.data() + layout.offset({0, y}), stride()};
+  }
+
+  // every row, top to bottom
+  auto rows() const {
+    return std::views::iota(0, matrix_size.y) |
+           std::views::transform([this](const int y) { return row(y); });
   }
 
   T location(const Vector2i& location) const {
     assert_valid_location(location);
-    return locations[static_cast<std::size_t>(location.y)]
-                    [static_cast<std::size_t>(location.x)];
+    return locations[layout.offset(location)];
   }
 
   T& location(const Vector2i& location) {
     assert_valid_location(location);
-    return locations[static_cast<std::size_t>(location.y)]
-                    [static_cast<std::size_t>(location.x)];
+    return locations[layout.offset(location)];
   }
 
   bool is_inside(const Vector2i& location) const {
-    return location.x >= 0 && location.x < size().x && location.y >= 0 &&
-           location.y < size().y;
+    return location.x >= 0 && location.x < matrix_size.x && location.y >= 0 &&
+           location.y < matrix_size.y;
   }
 
   friend std::ostream& operator<<(std::ostream& ostream,
@@ -130,21 +600,265 @@ class Matrix {
 
  private:
   void assert_valid_location([[maybe_unused]] const Vector2i& location) const {
-    assert(location.x >= 0);
-    assert(location.y >= 0);
-    assert(static_cast<std::size_t>(location.y) < locations.size());
-    assert(static_cast<std::size_t>(location.x) <
-           locations[static_cast<std::size_t>(location.y)].size());
+    assert(is_inside(location));
+  }
+
+  const T& cell_at(const std::size_t index) const {
+    if constexpr (Layout::IS_ROW_MAJOR) {
+      return locations[index];
+    } else {
+      return locations[layout.offset(location_at(index))];
+    }
   }
 
-  std::vector<std::vector<T>> locations;
+  Layout layout;
+  // cells in layout order, including any padding of the layout
+  std::vector<T> locations;
+  Vector2i matrix_size{};
 };
 
 std::ostream& operator<<(std::ostream& ostream, const Matrix<char>& matrix);
 
 using Grid = Matrix<char>;
 
-void print_grid(const Grid& grid, std::vector<Vector2i>& locations);
+Grid extract_grid(std::istream& istream);
+
+// Size from an optional first line "size=X,Y", which generated inputs start
+// with for days whose puzzle fixes the size; without one, default_size.
+Vector2i extract_size_line(std::istream& istream,
+                           const Vector2i& default_size);
+
+// Set of keys that map to dense indices [0, n_keys), such as grid locations,
+// stored as a bitmap plus the keys in insertion order. clear() only resets
+// the words of inserted keys, so a set can be reused cheaply.
+template <typename Key, typename KeyIndex>
+class DenseSet {
+ public:
+  DenseSet(const std::size_t n_keys, KeyIndex key_index)
+      : key_index{key_index}, words((n_keys + 63) / 64) {}
+
+  std::size_t size() const { return keys.size(); }
+  bool empty() const { return keys.empty(); }
+
+  auto begin() const { return keys.cbegin(); }
+  auto end() const { return keys.cend(); }
+
+  bool contains(const Key& key) const {
+    const auto index = key_index(key);
+    return (words[index / 64] >> (index % 64)) & 1;
+  }
+
+  // whether key was not in the set before
+  bool insert(const Key& key) {
+    const auto index = key_index(key);
+    const auto bit = std::uint64_t{1} << (index % 64);
+    if (words[index / 64] & bit) {
+      return false;
+    }
+    words[index / 64] |= bit;
+    keys.push_back(key);
+    return true;
+  }
+
+  void clear() {
+    for (const auto& key : keys) {
+      words[key_index(key) / 64] = 0;
+    }
+    keys.clear();
+  }
+
+ private:
+  KeyIndex key_index;
+  std::vector<std::uint64_t> words;
+  std::vector<Key> keys;
+};
+
+// row-major index of a location inside a grid of the given width
+struct LocationIndex {
+  int width;
+
+  std::size_t operator()(const Vector2i& location) const {
+    return static_cast<std::size_t>(location.y) *
+               static_cast<std::size_t>(width) +
+           static_cast<std::size_t>(location.x);
+  }
+};
+
+// set of locations inside a grid of the given size
+class LocationSet : public DenseSet<Vector2i, LocationIndex> {
+ public:
+  explicit LocationSet(const Vector2i& size)
+      : DenseSet{static_cast<std::size_t>(size.x) *
+                     static_cast<std::size_t>(size.y),
+                 LocationIndex{size.x}} {}
+};
+
+// Grid of one bit per location, packed into 64-bit words per row. Bit i of
+// word w of a row holds location x = 64 * w + i. Bits past the right edge of
+// the grid are always clear.
+class BitGrid {
+ public:
+  static constexpr auto WORD_BITS = 64;
+
+  BitGrid(const Vector2i& size)
+      : grid_size{size},
+        n_row_words{static_cast<std::size_t>(
+            (size.x + WORD_BITS - 1) / WORD_BITS)},
+        words(n_row_words * static_cast<std::size_t>(size.y)) {}
+
+  // set where predicate(matrix.location(location)) holds
+  template <typename T, typename Layout, typename Predicate>
+  BitGrid(const Matrix<T, Layout>& matrix, Predicate predicate)
+      : BitGrid{matrix.size()} {
+    for (auto y = 0; y < grid_size.y; y++) {
+      const auto bit_row = row(y);
+      auto x = 0uz;
+      for (const auto cell : matrix.row(y)) {
+        bit_row[x / WORD_BITS] |= std::uint64_t{predicate(cell)}
+                                  << (x % WORD_BITS);
+        x++;
+      }
+    }
+  }
+
+  Vector2i size() const { return grid_size; }
+
+  std::size_t row_words() const { return n_row_words; }
+
+  std::span<const std::uint64_t> row(const int y) const {
+    assert(y >= 0 && y < grid_size.y);
+    return {words.data() + static_cast<std::size_t>(y) * n_row_words,
+            n_row_words};
+  }
+
+  std::span<std::uint64_t> row(const int y) {
+    assert(y >= 0 && y < grid_size.y);
+    return {words.data() + static_cast<std::size_t>(y) * n_row_words,
+            n_row_words};
+  }
+
+  // Word word_index of row y as seen from dx columns to the right: bit i
+  // holds location x = 64 * word_index + i + dx. Locations outside the grid
+  // read as clear. Requires -64 < dx < 64.
+  std::uint64_t word(const int y, const std::size_t word_index,
+                     const int dx = 0) const {
+    assert(dx > -WORD_BITS && dx < WORD_BITS);
+    if (y < 0 || y >= grid_size.y) {
+      return 0;
+    }
+    const auto bits = row(y);
+    const auto at = [&](const std::size_t i) {
+      return i < n_row_words ? bits[i] : std::uint64_t{0};
+    };
+    if (dx > 0) {
+      return at(word_index) >> dx | at(word_index + 1) << (WORD_BITS - dx);
+    } else if (dx < 0) {
+      return at(word_index) << -dx |
+             (word_index > 0 ? at(word_index - 1) >> (WORD_BITS + dx) : 0);
+    }
+    return at(word_index);
+  }
+
+  bool location(const Vector2i& location) const {
+    assert(is_inside(location));
+    return row(location.y)[static_cast<std::size_t>(location.x / WORD_BITS)] >>
+               (location.x % WORD_BITS) &
+           1;
+  }
+
+  void set(const Vector2i& location, const bool value = true) {
+    assert(is_inside(location));
+    auto& bits =
+        row(location.y)[static_cast<std::size_t>(location.x / WORD_BITS)];
+    const auto mask = std::uint64_t{1} << (location.x % WORD_BITS);
+    bits = value ? bits | mask : bits & ~mask;
+  }
+
+  bool is_inside(const Vector2i& location) const {
+    return location.x >= 0 && location.x < grid_size.x && location.y >= 0 &&
+           location.y < grid_size.y;
+  }
+
+  std::size_t count() const {
+    std::size_t n = 0;
+    for (const auto bits : words) {
+      n += static_cast<std::size_t>(std::popcount(bits));
+    }
+    return n;
+  }
+
+  void clear() { std::ranges::fill(words, 0); }
+
+  // sets every location, leaving the bits past the right edge clear
+  void fill() {
+    std::ranges::fill(words, ~std::uint64_t{0});
+    const auto last_word_bits = grid_size.x % WORD_BITS;
+    if (last_word_bits == 0) {
+      return;
+    }
+    for (auto y = 0; y < grid_size.y; y++) {
+      row(y).back() = (std::uint64_t{1} << last_word_bits) - 1;
+    }
+  }
+
+ private:
+  Vector2i grid_size;
+  std::size_t n_row_words;
+  std::vector<std::uint64_t> words;
+};
+
+// Rows [y_begin, y_end) and row words [word_begin, word_end) of a BitGrid.
+struct BitGridBounds {
+  int y_begin = 0;
+  int y_end = 0;
+  std::size_t word_begin = 0;
+  std::size_t word_end = 0;
+
+  bool empty() const { return y_begin >= y_end || word_begin >= word_end; }
+};
+
+// Bit-parallel breadth-first search over the set locations of a mask. Each
+// step expands the whole frontier to its cardinal neighbours with shifts and
+// masks, 64 locations per word operation. The frontier is kept as a list of
+// its nonzero words, so a step only looks at those words and their
+// neighbours, and buffers are reused between searches, so many small
+// searches over a large mask stay cheap.
+class BitGridSearch {
+ public:
+  BitGridSearch(const Vector2i& size)
+      : visited_grid{size}, frontier{size}, next_frontier{size} {}
+
+  // number of steps from start to goal through mask, or nothing if the goal
+  // cannot be reached
+  std::optional<int> find_distance(const BitGrid& mask, const Vector2i& start,
+                                   const Vector2i& goal);
+
+  // locations reachable from start through mask, see visited()
+  void flood_fill(const BitGrid& mask, const Vector2i& start);
+
+  // locations visited by the last search and the bounds containing them
+  const BitGrid& visited() const { return visited_grid; }
+  const BitGridBounds& visited_bounds() const { return visited_box; }
+
+ private:
+  std::optional<int> search(const BitGrid& mask, const Vector2i& start,
+                            const std::optional<Vector2i>& goal);
+
+  struct WordLocation {
+    int y;
+    std::size_t word_index;
+  };
+
+  void visit(const BitGrid& mask, int y, std::size_t word_index);
+
+  BitGrid visited_grid;
+  BitGrid frontier;
+  BitGrid next_frontier;
+  BitGridBounds visited_box;
+  std::vector<WordLocation> visited_words;
+  std::vector<WordLocation> frontier_words;
+  std::vector<WordLocation> next_frontier_words;
+};
 
 template <typename T>
 std::ostream& operator<<(std::ostream& ostream,
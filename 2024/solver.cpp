@@ -0,0 +1,19 @@
+#include "solver.hpp"
+
+#include <map>
+#include <string>
+
+std::map<int, Solver>& solvers() {
+  static std::map<int, Solver> solvers_by_day;
+  return solvers_by_day;
+}
+
+std::map<int, std::map<std::string, Solver>>& solver_variants() {
+  static std::map<int, std::map<std::string, Solver>> variants_by_day;
+  return variants_by_day;
+}
+
+std::map<int, Replay>& replays() {
+  static std::map<int, Replay> replays_by_day;
+  return replays_by_day;
+}
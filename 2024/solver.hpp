@@ -0,0 +1,99 @@
+#pragma once
+
+#include "instrumentation.hpp"
+
+#include <chrono>
+#include <functional>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+// Answers and wall times of one parse, part 1 and part 2 run of a solver.
+struct Solution {
+  std::string part_1;
+  std::string part_2;
+  std::chrono::nanoseconds parse_time{};
+  std::chrono::nanoseconds part_1_time{};
+  std::chrono::nanoseconds part_2_time{};
+};
+
+using Solver = std::function<Solution(std::istream&)>;
+
+// Solvers by day. Each day's translation unit adds itself through
+// register_solver during static initialization.
+std::map<int, Solver>& solvers();
+
+template <typename T>
+std::string to_answer(const T& value) {
+  std::ostringstream ss;
+  ss << value;
+  return ss.str();
+}
+
+// Alternative solvers by day and name, which the runner's --variants option
+// runs next to the day's solver, for example to compare an optimized path
+// against the one it replaced.
+std::map<int, std::map<std::string, Solver>>& solver_variants();
+
+// Solver with separately timed parse, part 1 and part 2 steps. parse takes
+// the input stream and returns the input model, part_1 and part_2 take the
+// input model and return something printable.
+template <typename Parse, typename Part1, typename Part2>
+Solver make_solver(Parse parse, Part1 part_1, Part2 part_2) {
+  return [=](std::istream& istream) {
+    using Clock = std::chrono::steady_clock;
+    Solution solution;
+    const auto parse_start = Clock::now();
+    const auto input = parse(istream);
+    const auto part_1_start = Clock::now();
+    solution.part_1 = to_answer(part_1(input));
+    const auto part_2_start = Clock::now();
+    solution.part_2 = to_answer(part_2(input));
+    const auto part_2_end = Clock::now();
+    solution.parse_time = part_1_start - parse_start;
+    solution.part_1_time = part_2_start - part_1_start;
+    solution.part_2_time = part_2_end - part_2_start;
+    if constexpr (IS_INSTRUMENTATION_ENABLED) {
+      record_timer_event("parse", parse_start, part_1_start);
+      record_timer_event("part 1", part_1_start, part_2_start);
+      record_timer_event("part 2", part_2_start, part_2_end);
+    }
+    return solution;
+  };
+}
+
+// registers the solver of day, see make_solver
+template <typename Parse, typename Part1, typename Part2>
+bool register_solver(const int day, Parse parse, Part1 part_1, Part2 part_2) {
+  solvers()[day] = make_solver(parse, part_1, part_2);
+  return true;
+}
+
+// registers an alternative solver of day, see make_solver
+template <typename Parse, typename Part1, typename Part2>
+bool register_solver_variant(const int day, const std::string& name,
+                             Parse parse, Part1 part_1, Part2 part_2) {
+  solver_variants()[day][name] = make_solver(parse, part_1, part_2);
+  return true;
+}
+
+// Draws something worth watching about a day's input, such as an animation
+// of the puzzle, to the given stream. The runner's --replay option runs it
+// after the day is solved, so it never counts towards the solve times.
+using Replay = std::function<void(std::istream&, std::ostream&)>;
+
+// replays by day, which each day's translation unit adds through
+// register_replay
+std::map<int, Replay>& replays();
+
+// registers the replay of day; parse takes the input stream and returns the
+// input model, which replay draws to the stream it is given
+template <typename Parse, typename Render>
+bool register_replay(const int day, Parse parse, Render replay) {
+  replays()[day] = [=](std::istream& istream, std::ostream& ostream) {
+    replay(parse(istream), ostream);
+  };
+  return true;
+}